@@ -0,0 +1,297 @@
+module Chess.AnalysisServer;
+
+import nlohmann.json;
+import BS.thread_pool;
+
+import Chess.Arena;
+import Chess.MoveGeneration;
+import Chess.MoveSearch;
+import Chess.Position;
+import Chess.Position.RepetitionMap;
+import Chess.Rating;
+
+namespace chess {
+	struct AnalysisRequest {
+		nlohmann::json id;
+		std::string fen;
+		Position pos;
+		SearchLimits limits;
+		size_t multiPV = 1;
+	};
+
+	//results finish out of order, so every line is printed whole under a lock
+	class ResultPrinter {
+	private:
+		std::mutex m_mutex;
+	public:
+		void print(const nlohmann::json& j) {
+			auto line = j.dump();
+			std::scoped_lock l{ m_mutex };
+			std::println("{}", line);
+			std::fflush(stdout);
+		}
+	};
+
+	nlohmann::json makeError(const nlohmann::json& id, std::string_view message) {
+		nlohmann::json ret;
+		ret["id"] = id;
+		ret["error"] = message;
+		return ret;
+	}
+
+	std::optional<std::uint64_t> getUnsigned(const nlohmann::json& j, std::string_view key) {
+		auto it = j.find(key);
+		if (it == j.end() || !it->is_number_unsigned()) {
+			return std::nullopt;
+		}
+		return it->get<std::uint64_t>();
+	}
+
+	//returns the error message if the request is invalid
+	std::optional<std::string> parseRequest(const nlohmann::json& j, AnalysisRequest& request) {
+		request.id = j.value("id", nlohmann::json{});
+
+		auto fen = j.find("fen");
+		if (fen == j.end() || !fen->is_string()) {
+			return "missing fen";
+		}
+		request.fen = fen->get<std::string>();
+		if (auto parsed = request.pos.setFEN(request.fen); !parsed) {
+			return std::string{ getFENErrorMessage(parsed.error()) };
+		}
+
+		auto depth = getUnsigned(j, "depth");
+		auto nodes = getUnsigned(j, "nodes");
+		auto moveTime = getUnsigned(j, "movetime_ms");
+		if (!depth && !nodes && !moveTime) {
+			return "one of depth, nodes or movetime_ms is required";
+		}
+		if (depth) {
+			if (*depth < 1 || *depth > MAX_SEARCH_DEPTH.get()) {
+				return std::format("depth must be between 1 and {}", static_cast<std::uint32_t>(MAX_SEARCH_DEPTH.get()));
+			}
+			request.limits.depth = SafeUnsigned{ static_cast<std::uint8_t>(*depth) };
+		}
+		if (nodes) {
+			request.limits.nodes = *nodes;
+		}
+		if (moveTime) {
+			request.limits.moveTime = std::chrono::milliseconds{ *moveTime };
+		}
+		request.multiPV = std::max(getUnsigned(j, "multipv").value_or(1), std::uint64_t{ 1 });
+		return std::nullopt;
+	}
+
+	struct AnalysisLine {
+		Move move = Move::null();
+		SearchResult result; //rating is from white's perspective
+	};
+
+	nlohmann::json makeLineJSON(const AnalysisLine& line) {
+		nlohmann::json ret;
+		ret["move"] = line.move.getUCIString();
+		ret["rating"] = line.result.rating;
+		if (line.result.checkmateLevel) {
+			ret["checkmate_level"] = line.result.checkmateLevel->get();
+		}
+		ret["depth"] = line.result.depth.get();
+		ret["nodes"] = line.result.nodes;
+		return ret;
+	}
+
+	//multipv requests search every root move separately. At most maxThreadsPerRequest workers share
+	//the root moves of one request, so a single multipv request can't occupy the whole pool.
+	struct MultiPVState {
+		AnalysisRequest request;
+		SearchLimits rootMoveLimits; //each root move's share of the request's nodes and movetime
+		std::vector<Move> rootMoves;
+		std::vector<AnalysisLine> lines;
+		std::atomic<size_t> nextMoveIndex = 0;
+		std::atomic<size_t> runningWorkers = 0;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	//splits a request's budget between its root moves, so that a multipv request spends no more nodes in total and takes
+	//no longer than a single search would. Workers search their root moves one after another, so each of them gets the
+	//movetime of rootMoveCount / workerCount moves. The depth limit applies to every root move as is.
+	SearchLimits splitLimits(const SearchLimits& limits, size_t rootMoveCount, size_t workerCount) {
+		auto ret = limits;
+		rootMoveCount = std::max(rootMoveCount, 1uz);
+		if (limits.nodes) {
+			ret.nodes = std::max(*limits.nodes / rootMoveCount, std::uint64_t{ 1 });
+		}
+		if (limits.moveTime) {
+			auto movesPerWorker = (rootMoveCount + workerCount - 1) / workerCount;
+			ret.moveTime = std::max(*limits.moveTime / static_cast<std::int64_t>(movesPerWorker), std::chrono::milliseconds{ 1 });
+		}
+		return ret;
+	}
+
+	class AnalysisServer {
+	private:
+		const AnalysisServerOptions& m_options;
+		BS::thread_pool<> m_pool;
+		std::vector<IsolatedSearch> m_searches; //one per pool thread, cleared when the thread starts working on a request
+		ResultPrinter m_printer;
+
+		static constexpr auto SERVER_TABLE_SIZE = 1uz << 18;
+
+		IsolatedSearch& getThreadSearch() {
+			return m_searches[*BS::this_thread::get_index()];
+		}
+
+		//forgets the previous request's positions, which a new request is unlikely to share
+		IsolatedSearch& startRequest() {
+			auto& ret = getThreadSearch();
+			ret.clearPositionTable();
+			return ret;
+		}
+
+		void analyzeSingle(const AnalysisRequest& request) {
+			RepetitionMap repetitionMap;
+			repetitionMap.push(request.pos);
+			auto result = startRequest().search(request.pos, repetitionMap, request.limits);
+
+			nlohmann::json output;
+			output["id"] = request.id;
+			output["bestmove"] = result.bestMove ? result.bestMove->getUCIString() : "none";
+			if (result.bestMove) {
+				output["lines"] = nlohmann::json::array({ makeLineJSON({ *result.bestMove, result }) });
+			} else {
+				output["lines"] = nlohmann::json::array();
+			}
+			output["nodes"] = result.nodes;
+			output["time_ms"] = std::chrono::duration<double, std::milli>{ result.time }.count();
+			m_printer.print(output);
+		}
+
+		//the root moves of a worker share its transposition table, since their subtrees overlap
+		SearchResult searchRootMove(const MultiPVState& state, const Move& move) {
+			const auto& request = state.request;
+			Position child{ request.pos, move };
+			RepetitionMap repetitionMap;
+			repetitionMap.push(request.pos);
+			repetitionMap.push(child);
+
+			auto childLimits = state.rootMoveLimits;
+			if (childLimits.depth > 1_su8) {
+				childLimits.depth -= 1_su8;
+			}
+			auto ret = getThreadSearch().search(child, repetitionMap, childLimits);
+			ret.depth += 1_su8;
+
+			if (!ret.bestMove) { //the move ends the game
+				auto isCheckmate = calcPositionData(child).isCheckmate();
+				arena::resetThread();
+				ret.rating = isCheckmate ? (request.pos.isWhite() ? checkmatedRating<false>() : checkmatedRating<true>()) : 0_rt;
+			}
+			return ret;
+		}
+
+		void finishMultiPV(MultiPVState& state) {
+			auto& lines = state.lines;
+			std::uint64_t nodes = 0;
+			for (const auto& line : lines) {
+				nodes += line.result.nodes;
+			}
+
+			auto isWhite = state.request.pos.isWhite();
+			std::ranges::stable_sort(lines, [isWhite](const AnalysisLine& a, const AnalysisLine& b) {
+				return isWhite ? a.result.rating > b.result.rating : a.result.rating < b.result.rating;
+			});
+			lines.resize(std::min(lines.size(), state.request.multiPV));
+
+			nlohmann::json output;
+			output["id"] = state.request.id;
+			output["bestmove"] = lines.empty() ? "none" : lines.front().move.getUCIString();
+			output["lines"] = nlohmann::json::array();
+			for (const auto& line : lines) {
+				output["lines"].push_back(makeLineJSON(line));
+			}
+			output["nodes"] = nodes;
+			output["time_ms"] = std::chrono::duration<double, std::milli>{ std::chrono::steady_clock::now() - state.start }.count();
+			m_printer.print(output);
+		}
+
+		void runMultiPVWorker(std::shared_ptr<MultiPVState> state) {
+			startRequest();
+			for (auto i = state->nextMoveIndex++; i < state->rootMoves.size(); i = state->nextMoveIndex++) {
+				auto move = state->rootMoves[i];
+				state->lines[i] = { move, searchRootMove(*state, move) };
+			}
+			if (--state->runningWorkers == 0) {
+				finishMultiPV(*state);
+			}
+		}
+
+		void analyzeMultiPV(AnalysisRequest request) {
+			auto state = std::make_shared<MultiPVState>();
+			state->start = std::chrono::steady_clock::now();
+			{
+				auto posData = calcPositionData(request.pos);
+				state->rootMoves.assign(posData.legalMoves.begin(), posData.legalMoves.end());
+			}
+			arena::resetThread();
+			state->request = std::move(request);
+			state->lines.resize(state->rootMoves.size());
+
+			auto workerCount = std::clamp(state->rootMoves.size(), 1uz, m_options.maxThreadsPerRequest);
+			state->rootMoveLimits = splitLimits(state->request.limits, state->rootMoves.size(), workerCount);
+			state->runningWorkers = workerCount;
+			for (auto i = 1uz; i < workerCount; i++) {
+				m_pool.detach_task([this, state] {
+					runMultiPVWorker(state);
+				});
+			}
+			runMultiPVWorker(std::move(state)); //this task is one of the workers
+		}
+	public:
+		AnalysisServer(const AnalysisServerOptions& options) : m_options{ options }, m_pool{ std::max(options.threadCount, 1uz) } {
+			for (auto threadID : m_pool.get_thread_ids()) {
+				arena::registerThread(threadID);
+			}
+			for (auto i = 0uz; i < m_pool.get_thread_count(); i++) {
+				m_searches.emplace_back(SERVER_TABLE_SIZE);
+			}
+		}
+
+		void submit(std::string_view line) {
+			auto j = nlohmann::json::parse(line, nullptr, false);
+			if (j.is_discarded() || !j.is_object()) {
+				m_printer.print(makeError(nullptr, "request is not a JSON object"));
+				return;
+			}
+
+			AnalysisRequest request;
+			if (auto error = parseRequest(j, request)) {
+				m_printer.print(makeError(request.id, *error));
+				return;
+			}
+
+			m_pool.detach_task([this, request = std::move(request)]() mutable {
+				if (request.multiPV > 1) {
+					analyzeMultiPV(std::move(request));
+				} else {
+					analyzeSingle(request);
+				}
+			});
+		}
+
+		void wait() {
+			m_pool.wait();
+		}
+	};
+
+	void runAnalysisServer(const AnalysisServerOptions& options) {
+		AnalysisServer server{ options };
+
+		std::string line;
+		while (std::getline(std::cin, line)) {
+			if (line.find_first_not_of(" \t\r") == std::string::npos) {
+				continue;
+			}
+			server.submit(line);
+		}
+		server.wait();
+	}
+}
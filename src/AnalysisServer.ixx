@@ -0,0 +1,15 @@
+export module Chess.AnalysisServer;
+
+import std;
+
+export namespace chess {
+	struct AnalysisServerOptions {
+		size_t threadCount = std::thread::hardware_concurrency();
+		size_t maxThreadsPerRequest = 4; //only multipv requests are split across threads
+	};
+
+	//reads JSON lines requests from stdin until EOF and prints each result as a JSON line as soon as it finishes.
+	//Requests look like {"id": 1, "fen": "...", "depth": 8} with "nodes", "movetime_ms" and "multipv" being optional.
+	//multipv requests split nodes and movetime_ms between the root moves, so they cost about as much as a single search.
+	void runAnalysisServer(const AnalysisServerOptions& options);
+}
@@ -11,52 +11,66 @@ namespace chess {
 	namespace arena {
 		size_t globalByteCount = 0;
 		std::unique_ptr<std::byte[]> buff;
-		boost::unordered_flat_map<std::jthread::id, MemoryRegion, std::hash<std::jthread::id>> threadRegions;
+		//regions are boxed so that registering a thread can't move the regions other threads are using
+		boost::unordered_flat_map<std::jthread::id, std::unique_ptr<MemoryRegion>, std::hash<std::jthread::id>> threadRegions;
+		std::vector<std::unique_ptr<std::byte[]>> overflowBuffs; //for threads registered after the preallocated space runs out
+		std::mutex registrationMutex;
 
 		constexpr auto THREAD_BYTE_COUNT = 32'000'000uz;
 
 		void init() {
+			if (buff) { //embedders may have initialized the arena already
+				return;
+			}
 			auto threadCount = static_cast<size_t>(std::thread::hardware_concurrency() + 1); //add one for main thread; STATIC CAST IS CRUCIAL!!!!!!
-			//debugPrint(std::format("Reserved space for {} threads", threadCount));
-			//debugPrint(std::format("Total space: {} * {} = {}", THREAD_BYTE_COUNT, threadCount, THREAD_BYTE_COUNT * threadCount));
+			//debugPrint("Reserved space for {} threads", threadCount);
+			//debugPrint("Total space: {} * {} = {}", THREAD_BYTE_COUNT, threadCount, THREAD_BYTE_COUNT * threadCount);
 			globalByteCount = THREAD_BYTE_COUNT * threadCount;
 			buff = std::make_unique<std::byte[]>(globalByteCount);
 		}
 
 		void resetThread() {
-			auto& region = threadRegions.at(std::this_thread::get_id());
-			region.reset();
+			getMemoryRegion()->reset();
 		}
-		void resetAllThreads() {
-			for (auto& [id, region] : threadRegions) {
-				region.reset();
+		void resetThreads(std::span<const std::jthread::id> ids) {
+			std::scoped_lock l{ registrationMutex };
+			for (auto id : ids) {
+				threadRegions.at(id)->reset();
 			}
 		}
 
 		void registerThread(std::jthread::id id) {
 			static size_t threadIndex = 0;
 
-			debugPrint(std::format("registerThread called: {}", threadIndex));
+			std::scoped_lock l{ registrationMutex };
+			debugPrint("registerThread called: {}", threadIndex);
+			if (threadRegions.contains(id)) { //the id of a thread that exited was reused, so its region is free again
+				return;
+			}
 
 			auto offset = threadIndex * THREAD_BYTE_COUNT;
-			if (offset >= globalByteCount) {
-				debugPrint(std::format("Error: not enough space when registering {}", id));
-				debugPrint(std::format("Offset: {}; Space: {}", offset, globalByteCount));
-				debugPrintFlush();
-				std::exit(-1);
+			std::byte* begin = nullptr;
+			if (offset < globalByteCount) {
+				begin = buff.get() + offset;
+			} else {
+				debugPrint<LogLevel::Warning>("Preallocated arena space is full, allocating a region for {}", id);
+				begin = overflowBuffs.emplace_back(std::make_unique_for_overwrite<std::byte[]>(THREAD_BYTE_COUNT)).get();
 			}
-			auto begin = buff.get() + (threadIndex * THREAD_BYTE_COUNT);
-			threadRegions.emplace(id, MemoryRegion{ begin, THREAD_BYTE_COUNT });
+			threadRegions.emplace(id, std::make_unique<MemoryRegion>(begin, THREAD_BYTE_COUNT));
 			threadIndex++;
 		}
 
+		//cached, so that the map is only read once per thread and other threads can keep registering
 		MemoryRegion* getMemoryRegion() {
-			return &threadRegions.at(std::this_thread::get_id());
+			thread_local auto region = [] {
+				std::scoped_lock l{ registrationMutex };
+				return threadRegions.at(std::this_thread::get_id()).get();
+			}();
+			return region;
 		}
 
 		void* allocateImpl(size_t byteCount, size_t alignment) {
-			thread_local auto& region = threadRegions.at(std::this_thread::get_id());
-			return region.allocate(byteCount, alignment);
+			return getMemoryRegion()->allocate(byteCount, alignment);
 		}
 	}
 }
\ No newline at end of file
@@ -59,7 +59,8 @@ namespace chess {
 		export MemoryRegion* getMemoryRegion();
 		export void init();
 		export void resetThread();
-		export void resetAllThreads();
+		//resets only the given threads' regions, since other registered threads may be using theirs
+		export void resetThreads(std::span<const std::jthread::id> ids);
 		export void registerThread(std::jthread::id id);
 		
 		void* allocateImpl(size_t byteCount, size_t alignment);
@@ -3,12 +3,24 @@ export module Chess.Assert;
 import std;
 
 export namespace chess {
-	void zAssert(bool condition, std::source_location _sl = std::source_location::current()) {
-		if constexpr (USING_ASSERT) {
-			if (!condition) {
-				std::println("Assert failed: file {}, line {}", _sl.file_name(), _sl.line());
-				std::abort();
-			}
+	//the checked profile (tests, debugging) defines USING_ASSERT as true. Release builds leave it undefined or false.
+#ifdef USING_ASSERT
+	constexpr bool ASSERTS_ENABLED = USING_ASSERT;
+#else
+	constexpr bool ASSERTS_ENABLED = false;
+#endif
+
+	//checks the condition in every profile
+	inline void zCheck(bool condition, std::source_location _sl = std::source_location::current()) {
+		if (!condition) {
+			std::println("Assert failed: file {}, line {}", _sl.file_name(), _sl.line());
+			std::abort();
+		}
+	}
+
+	inline void zAssert(bool condition, std::source_location _sl = std::source_location::current()) {
+		if constexpr (ASSERTS_ENABLED) {
+			zCheck(condition, _sl);
 		}
 	}
-}
\ No newline at end of file
+}
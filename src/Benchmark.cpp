@@ -0,0 +1,46 @@
+module Chess.Benchmark;
+
+namespace chess {
+	const void* volatile benchmarkSink = nullptr;
+
+	void doNotOptimize(const void* value) {
+		benchmarkSink = value;
+	}
+
+	void MicrobenchmarkRunner::record(std::string_view name, std::uint64_t batchSize, std::span<BatchTime> repetitions, std::optional<perf::CounterValues> counters) {
+		std::ranges::sort(repetitions, {}, &BatchTime::time);
+		const auto& median = repetitions[repetitions.size() / 2];
+
+		MicrobenchmarkResult result;
+		result.name = name;
+		result.operationCount = batchSize * m_operationsPerCall;
+		result.nanosecondsPerOperation = static_cast<double>(median.time.count()) / static_cast<double>(result.operationCount);
+		result.cyclesPerOperation = static_cast<double>(median.cycles) / static_cast<double>(result.operationCount);
+		result.counters = counters;
+		result.countedOperationCount = result.operationCount * repetitions.size();
+		m_results.push_back(std::move(result));
+	}
+
+	void MicrobenchmarkRunner::printResults() const {
+		auto hasCounters = std::ranges::any_of(m_results, [](const MicrobenchmarkResult& result) {
+			return result.counters && (*result.counters)[perf::Event::Cycles] != 0;
+		});
+
+		std::print("{:<40} {:>12} {:>12}", "benchmark", "ns/op", "cycles/op");
+		if (hasCounters) {
+			std::print(" {:>6} {:>10} {:>10} {:>10}", "IPC", "L1D/op", "LLC/op", "brmiss/op");
+		}
+		std::println("");
+
+		for (const auto& result : m_results) {
+			std::print("{:<40} {:>12.1f} {:>12.1f}", result.name, result.nanosecondsPerOperation, result.cyclesPerOperation);
+			if (hasCounters && result.counters) {
+				const auto& counters = *result.counters;
+				auto operations = result.countedOperationCount;
+				std::print(" {:>6.2f} {:>10.3f} {:>10.3f} {:>10.3f}", counters.instructionsPerCycle(), counters.perOperation(perf::Event::L1DMisses, operations),
+					counters.perOperation(perf::Event::LLCMisses, operations), counters.perOperation(perf::Event::BranchMisses, operations));
+			}
+			std::println("");
+		}
+	}
+}
@@ -0,0 +1,88 @@
+module;
+
+#ifdef _WIN64
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+export module Chess.Benchmark;
+
+import std;
+
+export import Chess.PerfCounters;
+
+export namespace chess {
+	struct MicrobenchmarkResult {
+		std::string name;
+		std::uint64_t operationCount = 0;
+		double nanosecondsPerOperation = 0.0;
+		double cyclesPerOperation = 0.0; //TSC reference cycles
+		std::optional<perf::CounterValues> counters; //hardware counter totals over every measured batch, if enabled
+		std::uint64_t countedOperationCount = 0;
+	};
+
+	//stops the compiler from optimizing away a benchmarked result; defined in another translation unit so it can't be inlined
+	void doNotOptimize(const void* value);
+
+	class MicrobenchmarkRunner {
+	private:
+		static constexpr auto MIN_BATCH_TIME = std::chrono::milliseconds{ 20 };
+		static constexpr auto REPETITION_COUNT = 7uz;
+
+		struct BatchTime {
+			std::chrono::nanoseconds time{ 0 };
+			std::uint64_t cycles = 0;
+		};
+
+		std::uint64_t m_operationsPerCall = 1;
+		std::vector<MicrobenchmarkResult> m_results;
+
+		template<typename Operation>
+		static BatchTime timeBatch(Operation& operation, std::uint64_t batchSize) {
+			auto start = std::chrono::steady_clock::now();
+			auto startCycles = __rdtsc();
+			for (std::uint64_t i = 0; i < batchSize; i++) {
+				operation();
+			}
+			auto endCycles = __rdtsc();
+			auto end = std::chrono::steady_clock::now();
+			return { std::chrono::duration_cast<std::chrono::nanoseconds>(end - start), endCycles - startCycles };
+		}
+
+		void record(std::string_view name, std::uint64_t batchSize, std::span<BatchTime> repetitions, std::optional<perf::CounterValues> counters);
+	public:
+		//operationsPerCall is how many operations each call of a benchmarked function performs, e.g. one per corpus position
+		explicit MicrobenchmarkRunner(std::uint64_t operationsPerCall = 1)
+			: m_operationsPerCall{ std::max<std::uint64_t>(operationsPerCall, 1) }
+		{
+		}
+
+		//grows the batch until it takes MIN_BATCH_TIME, then reports the median of several batches
+		template<typename Operation>
+		void run(std::string_view name, Operation operation) {
+			operation(); //warm up caches and lazily loaded tables
+
+			std::uint64_t batchSize = 1;
+			while (timeBatch(operation, batchSize).time < MIN_BATCH_TIME && batchSize < (1ull << 32)) {
+				batchSize *= 2;
+			}
+
+			std::optional<perf::CounterValues> counters;
+			auto countersBefore = perf::isEnabled() ? perf::readThreadCounters() : perf::CounterValues{};
+			std::array<BatchTime, REPETITION_COUNT> repetitions;
+			for (auto& repetition : repetitions) {
+				repetition = timeBatch(operation, batchSize);
+			}
+			if (perf::isEnabled()) {
+				counters = perf::readThreadCounters() - countersBefore;
+			}
+			record(name, batchSize, repetitions, counters);
+		}
+
+		std::span<const MicrobenchmarkResult> getResults() const {
+			return m_results;
+		}
+		void printResults() const;
+	};
+}
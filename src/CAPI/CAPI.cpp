@@ -0,0 +1,210 @@
+#define AGENT_SMITH_BUILDING_LIBRARY
+#include "agent_smith.h"
+
+import std;
+
+import Chess.Arena;
+import Chess.Evaluation;
+import Chess.MoveGeneration;
+import Chess.MoveSearch;
+import Chess.PackedPosition;
+import Chess.Position;
+import Chess.Position.RepetitionMap;
+import Chess.SafeInt;
+
+using namespace chess;
+
+static_assert(sizeof(agent_smith_position) == sizeof(PackedPosition));
+static_assert(AGENT_SMITH_MAX_FEN_LENGTH == MAX_FEN_LENGTH);
+
+namespace {
+	std::once_flag arenaInitFlag;
+
+	//callers are arbitrary threads of another program, so each one is given an arena region on its first call
+	void prepareThread() {
+		thread_local const auto registered = [] {
+			std::call_once(arenaInitFlag, arena::init);
+			arena::registerThread(std::this_thread::get_id());
+			return true;
+		}();
+		(void)registered;
+	}
+
+	//the bytes come from another program, so they are checked before the engine relies on them.
+	//std::nullopt unless every piece nibble is a piece, each side has exactly one king and the en passant square is one
+	//that Position::setFEN would accept.
+	std::optional<Position> unpack(const agent_smith_position& position) {
+		auto packed = std::bit_cast<PackedPosition>(position);
+		auto pieceCount = static_cast<size_t>(std::popcount(packed.occupancy));
+		if (pieceCount > 2 * packed.pieces.size() || packed.enPassantSquare > PackedPosition::NO_EN_PASSANT_SQUARE) {
+			return std::nullopt;
+		}
+		for (size_t i = 0; i < pieceCount; i++) {
+			auto code = (packed.pieces[i / 2] >> (4 * (i % 2))) & 7;
+			if (code >= Piece::None) {
+				return std::nullopt;
+			}
+		}
+
+		//the jumped pawn is found one square behind the en passant square, which is only on the board from these ranks
+		auto isWhiteToMove = (packed.flags & PackedPosition::WHITE_TO_MOVE_FLAG) != 0;
+		if (packed.enPassantSquare != PackedPosition::NO_EN_PASSANT_SQUARE &&
+			rankOf(static_cast<Square>(packed.enPassantSquare)) != (isWhiteToMove ? 5 : 2))
+		{
+			return std::nullopt;
+		}
+
+		Position ret;
+		ret.setPos(packed);
+		auto [white, black] = ret.getColorSides();
+		if (std::popcount(white[King]) != 1 || std::popcount(black[King]) != 1) {
+			return std::nullopt;
+		}
+		const auto& enemies = ret.getTurnData().enemies;
+		if (enemies.doubleJumpedPawn != Square::None && !containsSquare(enemies[Pawn], enemies.doubleJumpedPawn)) {
+			return std::nullopt;
+		}
+		return ret;
+	}
+
+	agent_smith_move encodeMove(const Move& move) {
+		auto promotion = move.promotionPiece == Piece::None ? 0 : static_cast<int>(move.promotionPiece);
+		return static_cast<agent_smith_move>(static_cast<int>(move.from) | (static_cast<int>(move.to) << 6) | (promotion << 12));
+	}
+
+	//hands the memory used by func back to the arena once it returns
+	template<std::invocable Func>
+	std::invoke_result_t<Func> withArenaScope(Func func) {
+		auto region = arena::getMemoryRegion();
+		auto offset = region->getOffset();
+		if constexpr (std::is_void_v<std::invoke_result_t<Func>>) {
+			func();
+			region->resetToOffset(offset);
+		} else {
+			auto ret = func();
+			region->resetToOffset(offset);
+			return ret;
+		}
+	}
+}
+
+extern "C" {
+	agent_smith_status agent_smith_parse_fen(const char* fen, size_t fen_length, agent_smith_position* out) {
+		if (!fen || !out) {
+			return AGENT_SMITH_INVALID_ARGUMENT;
+		}
+		Position pos;
+		if (!pos.setFEN(std::string_view{ fen, fen_length })) {
+			return AGENT_SMITH_INVALID_FEN;
+		}
+		*out = std::bit_cast<agent_smith_position>(pos.pack());
+		return AGENT_SMITH_OK;
+	}
+
+	size_t agent_smith_write_fen(const agent_smith_position* position, char* out, size_t capacity) {
+		if (!position || !out) {
+			return 0;
+		}
+		auto pos = unpack(*position);
+		if (!pos) {
+			return 0;
+		}
+		std::array<char, MAX_FEN_LENGTH> buffer;
+		auto length = static_cast<size_t>(pos->writeFEN(buffer.begin()) - buffer.begin());
+		if (length + 1 > capacity) {
+			return 0;
+		}
+		std::ranges::copy_n(buffer.begin(), static_cast<std::ptrdiff_t>(length), out);
+		out[length] = '\0';
+		return length;
+	}
+
+	agent_smith_status agent_smith_generate_moves(const agent_smith_position* positions, size_t count, agent_smith_move* moves, 
+		size_t move_capacity, uint32_t* move_offsets) 
+	{
+		if ((count > 0 && (!positions || !move_offsets)) || (move_capacity > 0 && !moves)) {
+			return AGENT_SMITH_INVALID_ARGUMENT;
+		}
+		prepareThread();
+
+		if (count == 0) {
+			return AGENT_SMITH_OK;
+		}
+
+		size_t moveCount = 0;
+		move_offsets[0] = 0;
+		for (size_t i = 0; i < count; i++) {
+			auto pos = unpack(positions[i]);
+			if (!pos) {
+				return AGENT_SMITH_INVALID_ARGUMENT;
+			}
+			auto fits = withArenaScope([&] {
+				auto posData = calcPositionData(*pos);
+				if (posData.legalMoves.size() > move_capacity - moveCount) {
+					return false;
+				}
+				for (const auto& move : posData.legalMoves) {
+					moves[moveCount++] = encodeMove(move);
+				}
+				return true;
+			});
+			if (!fits) {
+				return AGENT_SMITH_BUFFER_TOO_SMALL;
+			}
+			move_offsets[i + 1] = static_cast<uint32_t>(moveCount);
+		}
+		return AGENT_SMITH_OK;
+	}
+
+	agent_smith_status agent_smith_evaluate(const agent_smith_position* positions, size_t count, float* ratings) {
+		if (count > 0 && (!positions || !ratings)) {
+			return AGENT_SMITH_INVALID_ARGUMENT;
+		}
+		prepareThread();
+
+		for (size_t i = 0; i < count; i++) {
+			auto pos = unpack(positions[i]);
+			if (!pos) {
+				return AGENT_SMITH_INVALID_ARGUMENT;
+			}
+			ratings[i] = withArenaScope([&] {
+				auto posData = calcPositionData(*pos);
+				return staticEvaluation(*pos, posData);
+			});
+		}
+		return AGENT_SMITH_OK;
+	}
+
+	agent_smith_status agent_smith_search(const agent_smith_position* positions, size_t count, uint8_t depth, 
+		agent_smith_move* best_moves, float* ratings) 
+	{
+		if (depth < 1 || depth > MAX_SEARCH_DEPTH.get() || (count > 0 && (!positions || !best_moves || !ratings))) {
+			return AGENT_SMITH_INVALID_ARGUMENT;
+		}
+		prepareThread();
+
+		//kept per thread, so that the table and repetition map are only allocated on a thread's first search
+		constexpr auto SEARCH_TABLE_SIZE = 1uz << 18;
+		thread_local IsolatedSearch search{ SEARCH_TABLE_SIZE };
+		thread_local RepetitionMap repetitionMap;
+
+		SearchLimits limits;
+		limits.depth = SafeUnsigned{ depth };
+		for (size_t i = 0; i < count; i++) {
+			auto pos = unpack(positions[i]);
+			if (!pos) {
+				return AGENT_SMITH_INVALID_ARGUMENT;
+			}
+			search.clearPositionTable();
+			repetitionMap.clear();
+			repetitionMap.push(*pos);
+
+			auto result = withArenaScope([&] {
+				return search.search(*pos, repetitionMap, limits);
+			});
+			best_moves[i] = result.bestMove ? encodeMove(*result.bestMove) : 0;
+			ratings[i] = result.rating;
+		}
+		return AGENT_SMITH_OK;
+	}
+}
@@ -0,0 +1,82 @@
+/* C interface to the engine, for tools written in other languages. Every function works on caller owned flat buffers
+   and allocates nothing per call, so it can be called from any thread without setup. */
+#ifndef AGENT_SMITH_H
+#define AGENT_SMITH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#ifdef AGENT_SMITH_BUILDING_LIBRARY
+#define AGENT_SMITH_API __declspec(dllexport)
+#else
+#define AGENT_SMITH_API __declspec(dllimport)
+#endif
+#else
+#define AGENT_SMITH_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the engine's 32 byte PackedPosition. Pieces are one nibble per occupied square in square order (a1 = 0, h8 = 63):
+   the piece type (king, queen, rook, bishop, knight, pawn) plus 8 for black pieces. */
+typedef struct agent_smith_position {
+	uint64_t occupancy;
+	uint8_t pieces[16];
+	uint8_t flags;             /* 1 = white to move, 2/4 = white kingside/queenside castling, 8/16 = black kingside/queenside */
+	uint8_t en_passant_square; /* 64 if there is none */
+	uint8_t halfmove_clock;
+	int8_t result;             /* training label, 0 if unused */
+	int16_t score;             /* training label, 0 if unused */
+	uint8_t reserved[2];
+} agent_smith_position;
+
+/* from | to << 6 | promotion << 12, where promotion is 0 for none, 1 = queen, 2 = rook, 3 = bishop, 4 = knight.
+   0 means no move, since a1a1 is never legal. */
+typedef uint16_t agent_smith_move;
+
+/* longest FEN agent_smith_write_fen can write, not counting the null terminator */
+#define AGENT_SMITH_MAX_FEN_LENGTH 92
+
+/* no position has more legal moves than this, so count * AGENT_SMITH_MAX_MOVES is always a big enough move buffer */
+#define AGENT_SMITH_MAX_MOVES 218
+
+typedef enum agent_smith_status {
+	AGENT_SMITH_OK = 0,
+	AGENT_SMITH_INVALID_FEN = 1,
+	AGENT_SMITH_BUFFER_TOO_SMALL = 2,
+	AGENT_SMITH_INVALID_ARGUMENT = 3
+} agent_smith_status;
+
+/* positions passed in must have exactly one king per side, a piece in every nibble that occupancy calls for and an
+   en passant square on the 6th rank with white to move or the 3rd with black to move, behind an enemy pawn, as
+   agent_smith_parse_fen writes them. Functions given any other position return AGENT_SMITH_INVALID_ARGUMENT, or 0
+   for agent_smith_write_fen, and only write the results of the positions before it. */
+
+/* parses fen_length characters of fen. The halfmove clock and fullmove number are optional. */
+AGENT_SMITH_API agent_smith_status agent_smith_parse_fen(const char* fen, size_t fen_length, agent_smith_position* out);
+
+/* writes a null terminated FEN. Returns its length, or 0 if capacity isn't enough or the position is invalid. The fullmove number is always 1. */
+AGENT_SMITH_API size_t agent_smith_write_fen(const agent_smith_position* position, char* out, size_t capacity);
+
+/* the legal moves of positions[i] are written to moves[move_offsets[i]] up to moves[move_offsets[i + 1]].
+   move_offsets holds count + 1 entries. On AGENT_SMITH_BUFFER_TOO_SMALL, only the positions before the one that
+   didn't fit are written. */
+AGENT_SMITH_API agent_smith_status agent_smith_generate_moves(const agent_smith_position* positions, size_t count,
+	agent_smith_move* moves, size_t move_capacity, uint32_t* move_offsets);
+
+/* static evaluation of each position, from white's perspective */
+AGENT_SMITH_API agent_smith_status agent_smith_evaluate(const agent_smith_position* positions, size_t count, float* ratings);
+
+/* searches each position to depth (1 to 29) with a fresh transposition table. best_moves[i] is 0 if positions[i] has
+   no legal moves. Ratings are from white's perspective. */
+AGENT_SMITH_API agent_smith_status agent_smith_search(const agent_smith_position* positions, size_t count, uint8_t depth,
+	agent_smith_move* best_moves, float* ratings);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
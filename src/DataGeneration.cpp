@@ -0,0 +1,150 @@
+module Chess.DataGeneration;
+
+import BS.thread_pool;
+
+import Chess.Arena;
+import Chess.EasyRandom;
+import Chess.MoveGeneration;
+import Chess.MoveSearch;
+import Chess.PackedPosition;
+import Chess.Position;
+import Chess.Position.RepetitionMap;
+import Chess.PositionCommand;
+import Chess.Rating;
+
+namespace chess {
+	std::int16_t toCentipawns(Rating rating) {
+		constexpr auto MAX_SCORE = 32000_rt;
+		return static_cast<std::int16_t>(std::clamp(rating * 100_rt, -MAX_SCORE, MAX_SCORE));
+	}
+
+	struct GameStart {
+		Position pos;
+		RepetitionMap repetitionMap;
+	};
+
+	//plays random legal moves, so that games don't all follow the same lines
+	std::optional<GameStart> makeRandomOpening(int plies) {
+		GameStart ret;
+		ret.pos.setPos(parsePositionCommand("startpos"));
+		ret.repetitionMap.push(ret.pos);
+
+		for (int i = 0; i < plies; i++) {
+			auto move = Move::null();
+			{
+				auto posData = calcPositionData(ret.pos);
+				if (posData.legalMoves.empty()) {
+					return std::nullopt;
+				}
+				auto moveIndex = makeRandomNum(0, static_cast<int>(posData.legalMoves.size()) - 1);
+				move = posData.legalMoves[static_cast<size_t>(moveIndex)];
+			}
+			arena::resetThread();
+			ret.pos.move(move);
+			ret.repetitionMap.push(ret.pos);
+		}
+		return ret;
+	}
+
+	bool isInCheck(const Position& pos) {
+		auto isCheck = calcPositionData(pos).isCheck;
+		arena::resetThread();
+		return isCheck;
+	}
+
+	//returns the result from white's perspective
+	std::int8_t playGame(IsolatedSearch& search, const DataGenerationOptions& options, std::vector<PackedPosition>& records) {
+		constexpr auto ADJUDICATION_RATING = 10_rt;
+
+		auto opening = makeRandomOpening(options.randomOpeningPlies);
+		while (!opening) {
+			opening = makeRandomOpening(options.randomOpeningPlies);
+		}
+		auto& [pos, repetitionMap] = *opening;
+
+		search.clearPositionTable();
+		SearchLimits limits;
+		limits.nodes = options.nodesPerMove;
+
+		for (int ply = 0; ply < options.maxPlies; ply++) {
+			if (repetitionMap.getPositionCount(pos) >= 3 || pos.pieceCount() == 2) {
+				return 0;
+			}
+
+			auto inCheck = isInCheck(pos);
+			auto result = search.search(pos, repetitionMap, limits);
+			if (!result.bestMove) {
+				if (!inCheck) {
+					return 0; //stalemate
+				}
+				return pos.isWhite() ? -1 : 1;
+			}
+			if (std::abs(result.rating) >= ADJUDICATION_RATING) {
+				return result.rating > 0_rt ? 1 : -1;
+			}
+
+			//only quiet positions are useful for training, since the static evaluation can't see through tactics
+			if (!inCheck && !result.bestMove->isMaterialChange()) {
+				auto record = pos.pack();
+				record.score = toCentipawns(result.rating);
+				records.push_back(record);
+			}
+
+			pos.move(*result.bestMove);
+			repetitionMap.push(pos);
+		}
+		return 0;
+	}
+
+	void generateTrainingData(const DataGenerationOptions& options) {
+		std::ofstream file{ options.outputPath, std::ios::binary | std::ios::app };
+		if (!file.is_open()) {
+			std::println("Error: could not open {}", options.outputPath.string());
+			return;
+		}
+		std::mutex fileMutex;
+
+		BS::thread_pool<> pool{ std::thread::hardware_concurrency() };
+		for (auto threadID : pool.get_thread_ids()) {
+			arena::registerThread(threadID);
+		}
+
+		constexpr auto DATA_GENERATION_TABLE_SIZE = 1uz << 16; //fixed node searches are tiny
+		std::vector<IsolatedSearch> searches;
+		std::vector<PackedPositionWriter> writers;
+		for (auto i = 0uz; i < pool.get_thread_count(); i++) {
+			searches.emplace_back(DATA_GENERATION_TABLE_SIZE);
+			writers.emplace_back(file, fileMutex);
+		}
+
+		std::atomic<size_t> gamesPlayed = 0;
+		std::atomic<size_t> positionsWritten = 0;
+		auto start = std::chrono::steady_clock::now();
+
+		pool.detach_sequence(0uz, options.gameCount, [&](size_t) {
+			thread_local std::vector<PackedPosition> records;
+			records.clear();
+
+			auto threadIndex = *BS::this_thread::get_index();
+			auto result = playGame(searches[threadIndex], options, records);
+			for (auto& record : records) {
+				record.result = result;
+			}
+			writers[threadIndex].write(records);
+
+			positionsWritten += records.size();
+			constexpr auto PROGRESS_INTERVAL = 100uz;
+			if (++gamesPlayed % PROGRESS_INTERVAL == 0) {
+				std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+				auto positions = positionsWritten.load();
+				std::println("Games: {} | positions: {} ({:.0f}/s)", gamesPlayed.load(), positions, static_cast<double>(positions) / seconds.count());
+			}
+		});
+		pool.wait();
+
+		for (auto& writer : writers) {
+			writer.flush();
+		}
+		std::println("Finished: {} games, {} positions written to {}", gamesPlayed.load(), positionsWritten.load(), options.outputPath.string());
+	}
+}
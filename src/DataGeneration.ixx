@@ -0,0 +1,16 @@
+export module Chess.DataGeneration;
+
+import std;
+
+export namespace chess {
+	struct DataGenerationOptions {
+		std::filesystem::path outputPath;
+		size_t gameCount = 0;
+		std::uint64_t nodesPerMove = 5000;
+		int randomOpeningPlies = 8;
+		int maxPlies = 400;
+	};
+
+	//plays self-play games on every core and writes (position, score, result) records for quiet positions
+	void generateTrainingData(const DataGenerationOptions& options);
+}
@@ -3,34 +3,169 @@ module Chess.DebugPrint;
 import Chess.EnvironmentVariable;
 
 namespace chess {
-	class Buffer {
+	constexpr std::array LOG_LEVEL_NAMES{ "debug", "info", "warning", "error", "off" };
+
+	struct RecordHeader {
+		std::chrono::steady_clock::time_point time;
+		std::thread::id threadID;
+		std::uint16_t length = 0;
+		LogLevel level = LogLevel::Debug;
+	};
+
+	//single producer (the owning thread), single consumer (the drain). Indexes only grow, so write - read is the used space.
+	class ThreadLog {
+	private:
+		static constexpr size_t CAPACITY = 1uz << 16;
+
+		std::array<char, CAPACITY> m_data;
+		alignas(std::hardware_destructive_interference_size) std::atomic<size_t> m_writeIndex{ 0 };
+		alignas(std::hardware_destructive_interference_size) std::atomic<size_t> m_readIndex{ 0 };
+		std::atomic<std::uint64_t> m_droppedCount{ 0 };
+
+		void copyIn(size_t index, const void* source, size_t size) {
+			auto offset = index % CAPACITY;
+			auto firstPart = std::min(size, CAPACITY - offset);
+			std::memcpy(m_data.data() + offset, source, firstPart);
+			std::memcpy(m_data.data(), static_cast<const char*>(source) + firstPart, size - firstPart);
+		}
+		void copyOut(size_t index, void* destination, size_t size) const {
+			auto offset = index % CAPACITY;
+			auto firstPart = std::min(size, CAPACITY - offset);
+			std::memcpy(destination, m_data.data() + offset, firstPart);
+			std::memcpy(static_cast<char*>(destination) + firstPart, m_data.data(), size - firstPart);
+		}
+	public:
+		std::atomic<bool> inUse{ true };
+		ThreadLog* next = nullptr; //set before the log is published and never changed
+
+		void push(const RecordHeader& header, std::string_view message) {
+			auto recordSize = sizeof(RecordHeader) + message.size();
+			auto writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+			auto readIndex = m_readIndex.load(std::memory_order_acquire);
+			if (CAPACITY - (writeIndex - readIndex) < recordSize) {
+				m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			copyIn(writeIndex, &header, sizeof(RecordHeader));
+			copyIn(writeIndex + sizeof(RecordHeader), message.data(), message.size());
+			m_writeIndex.store(writeIndex + recordSize, std::memory_order_release);
+		}
+
+		template<typename Consumer>
+		void drain(Consumer&& consumer) {
+			auto readIndex = m_readIndex.load(std::memory_order_relaxed);
+			auto writeIndex = m_writeIndex.load(std::memory_order_acquire);
+			std::string message;
+			while (readIndex != writeIndex) {
+				RecordHeader header;
+				copyOut(readIndex, &header, sizeof(RecordHeader));
+				message.resize(header.length);
+				copyOut(readIndex + sizeof(RecordHeader), message.data(), header.length);
+				readIndex += sizeof(RecordHeader) + header.length;
+				consumer(header, message);
+			}
+			m_readIndex.store(readIndex, std::memory_order_release);
+		}
+
+		std::uint64_t takeDroppedCount() {
+			return m_droppedCount.exchange(0, std::memory_order_relaxed);
+		}
+	};
+
+	class Logger {
 	private:
-		std::unordered_map<std::thread::id, std::string> m_map;
-		std::mutex m_mutex;
+		static constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds{ 50 };
+
+		std::atomic<ThreadLog*> m_logs{ nullptr }; //lock-free list, logs are reused rather than removed
+		std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+		std::mutex m_drainMutex; //only taken by the draining threads, never by the loggers
+		std::ofstream m_file{ getAssetDirectoryPath() / "debug_output.txt" };
+		std::jthread m_drainThread;
+
+		void writeRecord(const RecordHeader& header, std::string_view message) {
+			auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(header.time - m_start).count();
+			std::println(m_file, "[{:>12}us] [{}] [{}] {}", microseconds, header.threadID, 
+				LOG_LEVEL_NAMES[static_cast<size_t>(header.level)], message);
+		}
 	public:
-		void add(const std::string& s) {
-			std::scoped_lock l{ m_mutex };
-			m_map[std::this_thread::get_id()] += s + '\n';
-		}
-		void flush() {
-			std::scoped_lock l{ m_mutex };
-			std::ofstream file{ getAssetDirectoryPath() / "debug_output.txt" };
-			for (const auto& [id, text] : m_map) {
-				file << std::format("Thread [{}]: \n", id);
-				file << text << '\n';
+		Logger() {
+			m_drainThread = std::jthread{ [this](std::stop_token stopToken) {
+				std::mutex sleepMutex;
+				std::condition_variable_any sleepCondition;
+				while (!stopToken.stop_requested()) {
+					std::unique_lock l{ sleepMutex };
+					sleepCondition.wait_for(l, stopToken, DRAIN_INTERVAL, [] { return false; });
+					l.unlock();
+					drain();
+				}
+			} };
+		}
+		~Logger() {
+			m_drainThread.request_stop();
+			m_drainThread.join();
+			drain();
+
+			auto log = m_logs.load(std::memory_order_acquire);
+			while (log) {
+				delete std::exchange(log, log->next);
 			}
 		}
-		~Buffer() {
-			flush();
+
+		ThreadLog* claimLog() {
+			for (auto log = m_logs.load(std::memory_order_acquire); log; log = log->next) {
+				auto expected = false;
+				if (log->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+					return log;
+				}
+			}
+
+			auto log = new ThreadLog;
+			log->next = m_logs.load(std::memory_order_relaxed);
+			while (!m_logs.compare_exchange_weak(log->next, log, std::memory_order_release, std::memory_order_relaxed)) {
+			}
+			return log;
+		}
+
+		void drain() {
+			std::scoped_lock l{ m_drainMutex };
+			for (auto log = m_logs.load(std::memory_order_acquire); log; log = log->next) {
+				log->drain([&](const RecordHeader& header, std::string_view message) {
+					writeRecord(header, message);
+				});
+				if (auto dropped = log->takeDroppedCount()) {
+					std::println(m_file, "[{} messages dropped because a thread's log was full]", dropped);
+				}
+			}
+			m_file.flush();
 		}
 	};
-	Buffer buff;
 
-	void debugPrint(const std::string& s) {
-		buff.add(s);
+	Logger& getLogger() {
+		static Logger logger;
+		return logger;
+	}
+
+	//hands the thread's log back for reuse when the thread exits
+	struct ThreadLogHandle {
+		ThreadLog* log = getLogger().claimLog();
+
+		~ThreadLogHandle() {
+			log->inUse.store(false, std::memory_order_release);
+		}
+	};
+
+	void writeLogRecord(LogLevel level, std::string_view message) {
+		thread_local ThreadLogHandle handle;
+
+		RecordHeader header;
+		header.time = std::chrono::steady_clock::now();
+		header.threadID = std::this_thread::get_id();
+		header.length = static_cast<std::uint16_t>(std::min(message.size(), MAX_LOG_MESSAGE_LENGTH));
+		header.level = level;
+		handle.log->push(header, message.substr(0, header.length));
 	}
 
 	void debugPrintFlush() {
-		buff.flush();
+		getLogger().drain();
 	}
-}
\ No newline at end of file
+}
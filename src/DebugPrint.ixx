@@ -3,6 +3,37 @@ export module Chess.DebugPrint;
 import std;
 
 export namespace chess {
-	void debugPrint(const std::string& s);
+	enum class LogLevel : std::uint8_t {
+		Debug,
+		Info,
+		Warning,
+		Error,
+		Off
+	};
+
+	//messages below this level compile to nothing. Set with LOG_LEVEL (0 = Debug ... 4 = Off).
+#ifdef LOG_LEVEL
+	constexpr auto MIN_LOG_LEVEL = static_cast<LogLevel>(LOG_LEVEL);
+#else
+	constexpr auto MIN_LOG_LEVEL = LogLevel::Debug;
+#endif
+
+	constexpr size_t MAX_LOG_MESSAGE_LENGTH = 1024; //longer messages are truncated
+
+	//copies the message into the calling thread's ring buffer. Never blocks: if the buffer is full the message is dropped.
+	void writeLogRecord(LogLevel level, std::string_view message);
+
+	//formats on the calling thread, then a background thread writes the record to debug_output.txt
+	template<LogLevel Level = LogLevel::Debug, typename... Args>
+	void debugPrint(std::format_string<Args...> fmt, Args&&... args) {
+		if constexpr (Level >= MIN_LOG_LEVEL && Level != LogLevel::Off) {
+			std::array<char, MAX_LOG_MESSAGE_LENGTH> message;
+			auto result = std::format_to_n(message.data(), message.size(), fmt, std::forward<Args>(args)...);
+			auto length = std::min(static_cast<size_t>(result.size), message.size());
+			writeLogRecord(Level, { message.data(), length });
+		}
+	}
+
+	//writes every record logged so far before returning
 	void debugPrintFlush();
-}
\ No newline at end of file
+}
@@ -0,0 +1,98 @@
+module Chess.EPD;
+
+
+namespace chess {
+	std::string_view trim(std::string_view str) {
+		auto begin = str.find_first_not_of(" \t\r\n");
+		if (begin == std::string_view::npos) {
+			return {};
+		}
+		auto end = str.find_last_not_of(" \t\r\n");
+		return str.substr(begin, end - begin + 1);
+	}
+
+	auto splitWords(std::string_view str) {
+		return str | std::views::split(' ') | std::views::transform([](auto&& rng) {
+			return std::string_view{ rng.data(), rng.size() };
+		}) | std::views::filter([](std::string_view word) {
+			return !word.empty();
+		});
+	}
+
+	void parseOperation(std::string_view operation, EPDEntry& entry) {
+		operation = trim(operation);
+		auto opcodeEnd = operation.find(' ');
+		if (opcodeEnd == std::string_view::npos) {
+			return;
+		}
+		auto opcode = operation.substr(0, opcodeEnd);
+		auto operands = trim(operation.substr(opcodeEnd));
+
+		auto addMoves = [&](std::vector<std::string>& moves) {
+			for (auto word : splitWords(operands)) {
+				moves.emplace_back(word);
+			}
+		};
+		if (opcode == "bm") {
+			addMoves(entry.bestMoves);
+		} else if (opcode == "am") {
+			addMoves(entry.avoidMoves);
+		} else if (opcode == "id") {
+			if (operands.size() >= 2 && operands.front() == '"' && operands.back() == '"') {
+				operands = operands.substr(1, operands.size() - 2);
+			}
+			entry.id = std::string{ operands };
+		} //other opcodes (c0, ce, acd, ...) are ignored
+	}
+
+	std::optional<EPDEntry> parseEPDLine(std::string_view line) {
+		line = trim(line);
+		if (line.empty() || line.starts_with('#')) {
+			return std::nullopt;
+		}
+
+		//the first four fields are the board, side to move, castling rights and en passant square
+		constexpr auto FEN_FIELD_COUNT = 4;
+		auto fieldsEnd = 0uz;
+		for (int i = 0; i < FEN_FIELD_COUNT; i++) {
+			auto fieldBegin = line.find_first_not_of(' ', fieldsEnd);
+			if (fieldBegin == std::string_view::npos) {
+				return std::nullopt;
+			}
+			fieldsEnd = std::min(line.find(' ', fieldBegin), line.size());
+		}
+
+		EPDEntry ret;
+		ret.fen = std::string{ line.substr(0, fieldsEnd) };
+		if (!ret.pos.setFEN(ret.fen)) {
+			return std::nullopt;
+		}
+
+		auto operations = line.substr(fieldsEnd);
+		for (auto&& operation : operations | std::views::split(';')) {
+			parseOperation(std::string_view{ operation.data(), operation.size() }, ret);
+		}
+
+		return ret;
+	}
+
+	std::vector<EPDEntry> loadEPDFile(const std::filesystem::path& path) {
+		std::ifstream file{ path };
+		if (!file.is_open()) {
+			std::println("Error: could not open {}", path.string());
+			std::exit(-1);
+		}
+
+		std::vector<EPDEntry> ret;
+		std::string line;
+		while (std::getline(file, line)) {
+			if (auto entry = parseEPDLine(line)) {
+				if (entry->id.empty()) {
+					entry->id = std::to_string(ret.size() + 1);
+				}
+				ret.push_back(std::move(*entry));
+			}
+		}
+		return ret;
+	}
+}
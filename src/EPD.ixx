@@ -0,0 +1,18 @@
+export module Chess.EPD;
+
+import std;
+
+export import Chess.Position;
+
+export namespace chess {
+	struct EPDEntry {
+		std::string id;
+		std::string fen; //the first four FEN fields, exactly as they appear in the file
+		Position pos;
+		std::vector<std::string> bestMoves; //SAN
+		std::vector<std::string> avoidMoves; //SAN
+	};
+
+	std::optional<EPDEntry> parseEPDLine(std::string_view line);
+	std::vector<EPDEntry> loadEPDFile(const std::filesystem::path& path);
+}
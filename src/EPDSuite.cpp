@@ -0,0 +1,138 @@
+module Chess.EPDSuite;
+
+import nlohmann.json;
+import BS.thread_pool;
+
+import Chess.Arena;
+import Chess.EPD;
+import Chess.MoveGeneration;
+import Chess.Position.RepetitionMap;
+import Chess.SAN;
+
+namespace chess {
+	struct SuiteResult {
+		std::optional<Move> foundMove;
+		bool solved = false;
+		std::optional<std::chrono::nanoseconds> timeToSolution;
+		SafeUnsigned<std::uint8_t> depth{ 0 };
+		std::uint64_t nodes = 0;
+		std::vector<std::string> unresolvedMoves; //SAN that doesn't match a legal move
+	};
+
+	std::vector<Move> resolveSANMoves(const std::vector<std::string>& sanMoves, std::span<const Move> legalMoves, SuiteResult& result) {
+		std::vector<Move> ret;
+		for (const auto& san : sanMoves) {
+			if (auto move = parseSANMove(san, legalMoves)) {
+				ret.push_back(*move);
+			} else {
+				result.unresolvedMoves.push_back(san);
+			}
+		}
+		return ret;
+	}
+
+	SuiteResult solve(IsolatedSearch& search, const EPDEntry& entry, const SearchLimits& limits) {
+		SuiteResult ret;
+
+		//copy the moves out of the arena before the search resets it
+		std::vector<Move> bestMoves;
+		std::vector<Move> avoidMoves;
+		{
+			auto posData = calcPositionData(entry.pos);
+			bestMoves = resolveSANMoves(entry.bestMoves, posData.legalMoves, ret);
+			avoidMoves = resolveSANMoves(entry.avoidMoves, posData.legalMoves, ret);
+		}
+
+		auto isSolution = [&](const std::optional<Move>& move) {
+			if (!move || (bestMoves.empty() && avoidMoves.empty())) {
+				return false;
+			}
+			auto isBest = bestMoves.empty() || std::ranges::contains(bestMoves, *move);
+			return isBest && !std::ranges::contains(avoidMoves, *move);
+		};
+
+		RepetitionMap repetitionMap;
+		repetitionMap.push(entry.pos);
+
+		search.clearPositionTable();
+		auto result = search.search(entry.pos, repetitionMap, limits, [&](const SearchResult& iteration) {
+			//the position only counts as solved at the iteration after which the engine never changed its mind
+			if (!isSolution(iteration.bestMove)) {
+				ret.timeToSolution = std::nullopt;
+			} else if (!ret.timeToSolution) {
+				ret.timeToSolution = iteration.time;
+			}
+		});
+
+		ret.foundMove = result.bestMove;
+		ret.solved = isSolution(result.bestMove);
+		if (!ret.solved) {
+			ret.timeToSolution = std::nullopt;
+		}
+		ret.depth = result.depth;
+		ret.nodes = result.nodes;
+		return ret;
+	}
+
+	nlohmann::json makeJSON(const EPDEntry& entry, const SuiteResult& result) {
+		using namespace std::chrono;
+
+		nlohmann::json ret;
+		ret["id"] = entry.id;
+		ret["fen"] = entry.fen;
+		ret["best_moves"] = entry.bestMoves;
+		ret["avoid_moves"] = entry.avoidMoves;
+		ret["found_move"] = result.foundMove ? result.foundMove->getUCIString() : "none";
+		ret["solved"] = result.solved;
+		if (result.timeToSolution) {
+			ret["time_to_solution_ms"] = duration<double, std::milli>{ *result.timeToSolution }.count();
+		} else {
+			ret["time_to_solution_ms"] = nullptr;
+		}
+		ret["depth"] = result.depth.get();
+		ret["nodes"] = result.nodes;
+		if (!result.unresolvedMoves.empty()) {
+			ret["unresolved_moves"] = result.unresolvedMoves;
+		}
+		return ret;
+	}
+
+	void runEPDSuite(const std::filesystem::path& path, const SearchLimits& limits) {
+		auto entries = loadEPDFile(path);
+
+		BS::thread_pool<> pool{ std::thread::hardware_concurrency() };
+		for (auto threadID : pool.get_thread_ids()) {
+			arena::registerThread(threadID);
+		}
+		
+		constexpr auto SUITE_TABLE_SIZE = 1uz << 18; //positions are independent, so each thread only needs a small table
+		std::vector<IsolatedSearch> searches;
+		for (auto i = 0uz; i < pool.get_thread_count(); i++) {
+			searches.emplace_back(SUITE_TABLE_SIZE);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		auto results = pool.submit_sequence(0uz, entries.size(), [&](size_t i) {
+			auto& search = searches[*BS::this_thread::get_index()];
+			return solve(search, entries[i], limits);
+		}).get();
+		auto totalTime = std::chrono::steady_clock::now() - start;
+
+		nlohmann::json output;
+		output["positions"] = nlohmann::json::array();
+		auto solvedCount = 0uz;
+		std::uint64_t totalNodes = 0;
+		for (const auto& [entry, result] : std::views::zip(entries, results)) {
+			output["positions"].push_back(makeJSON(entry, result));
+			solvedCount += result.solved ? 1 : 0;
+			totalNodes += result.nodes;
+		}
+		output["total"] = entries.size();
+		output["solved"] = solvedCount;
+		output["solve_rate"] = entries.empty() ? 0.0 : static_cast<double>(solvedCount) / static_cast<double>(entries.size());
+		output["nodes"] = totalNodes;
+		output["time_ms"] = std::chrono::duration<double, std::milli>{ totalTime }.count();
+
+		std::println("{}", output.dump(2));
+	}
+}
@@ -0,0 +1,10 @@
+export module Chess.EPDSuite;
+
+import std;
+
+export import Chess.MoveSearch;
+
+export namespace chess {
+	//searches every position of an EPD file concurrently and prints the results as JSON
+	void runEPDSuite(const std::filesystem::path& path, const SearchLimits& limits);
+}
@@ -0,0 +1,111 @@
+module Chess.Engine;
+
+import Chess.Arena;
+
+namespace chess {
+	struct EngineState {
+		IsolatedSearch search;
+		std::mutex analysisMutex; //held for the whole of an analysis, so they run one at a time
+
+		std::mutex jobMutex;
+		std::condition_variable_any jobCV;
+		std::move_only_function<void()> job;
+		std::uint64_t requestedAnalyses = 0; //guarded by jobMutex, like cancelledAnalyses
+		std::uint64_t cancelledAnalyses = 0; //every analysis numbered up to this was requested before the last cancel
+
+		std::jthread thread; //declared last, so it is joined before the rest of the state is destroyed
+
+		explicit EngineState(const EngineOptions& options)
+			: search{ options.positionTableSize }
+		{
+			arena::init(); //does nothing if the arena was already initialized
+			thread = std::jthread{ [this](std::stop_token stopToken) { run(stopToken); } };
+		}
+
+		void run(std::stop_token stopToken) {
+			arena::registerThread(std::this_thread::get_id());
+			while (true) {
+				std::move_only_function<void()> currJob;
+				{
+					std::unique_lock l{ jobMutex };
+					if (!jobCV.wait(l, stopToken, [this] { return job != nullptr; })) {
+						return;
+					}
+					currJob = std::move(job);
+					job = nullptr;
+				}
+				currJob();
+			}
+		}
+
+		//numbers an analysis when it is requested, before it waits for the ones ahead of it
+		std::uint64_t requestAnalysis() {
+			std::scoped_lock l{ jobMutex };
+			return ++requestedAnalyses;
+		}
+
+		//runs func on the search thread and waits for its result. The search starts out cancelled if cancel was called
+		//after the analysis was requested.
+		template<std::invocable Func>
+		std::invoke_result_t<Func> runOnSearchThread(std::uint64_t analysisNumber, Func func) {
+			std::packaged_task<std::invoke_result_t<Func>()> task{ std::move(func) };
+			auto result = task.get_future();
+			{
+				std::scoped_lock l{ jobMutex };
+				if (analysisNumber <= cancelledAnalyses) {
+					search.cancel();
+				} else {
+					search.resetCancel();
+				}
+				job = std::move(task);
+			}
+			jobCV.notify_one();
+			return result.get();
+		}
+	};
+
+	Engine::Engine(const EngineOptions& options)
+		: m_state{ std::make_unique<EngineState>(options) }
+	{
+	}
+
+	Engine::Engine(Engine&&) noexcept = default;
+	Engine& Engine::operator=(Engine&&) noexcept = default;
+
+	Engine::~Engine() {
+		if (m_state) {
+			cancel();
+		}
+	}
+
+	Analysis Engine::analyze(const Position& pos, const SearchLimits& limits, AnalysisCallback onIteration) {
+		RepetitionMap history;
+		history.push(pos);
+		return analyze(pos, history, limits, std::move(onIteration));
+	}
+
+	Analysis Engine::analyze(const Position& pos, const RepetitionMap& history, const SearchLimits& limits, AnalysisCallback onIteration) {
+		auto analysisNumber = m_state->requestAnalysis();
+		std::scoped_lock l{ m_state->analysisMutex };
+		return m_state->runOnSearchThread(analysisNumber, [&] {
+			auto& search = m_state->search;
+			auto result = search.search(pos, history, limits, [&](const SearchResult& iteration) {
+				if (onIteration) {
+					onIteration(Analysis{ iteration, search.getPrincipalVariation(pos, iteration) });
+				}
+			});
+			return Analysis{ result, search.getPrincipalVariation(pos, result) };
+		});
+	}
+
+	void Engine::cancel() {
+		std::scoped_lock l{ m_state->jobMutex }; //can't interleave with a job being queued
+		m_state->cancelledAnalyses = m_state->requestedAnalyses;
+		m_state->search.cancel();
+	}
+
+	void Engine::newGame() {
+		std::scoped_lock l{ m_state->analysisMutex };
+		m_state->search.clearPositionTable();
+	}
+}
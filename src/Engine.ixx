@@ -0,0 +1,47 @@
+export module Chess.Engine;
+
+export import std;
+export import Chess.Move;
+export import Chess.MoveSearch;
+export import Chess.Position;
+export import Chess.Position.RepetitionMap;
+
+namespace chess {
+	export struct EngineOptions {
+		size_t positionTableSize = IsolatedSearch::DEFAULT_TABLE_SIZE;
+	};
+
+	export struct Analysis {
+		SearchResult result; //rating is from white's perspective
+		std::vector<Move> principalVariation; //starts with result.bestMove. Empty if there are no legal moves.
+	};
+
+	//called on the engine's search thread after every completed iterative deepening iteration
+	export using AnalysisCallback = std::move_only_function<void(const Analysis&)>;
+
+	struct EngineState;
+
+	//in-process analysis for programs that embed the engine, without UCI's text protocol. Each Engine searches on a thread
+	//of its own and keeps its transposition table between analyses.
+	export class Engine {
+	private:
+		std::unique_ptr<EngineState> m_state;
+	public:
+		explicit Engine(const EngineOptions& options = {});
+		Engine(Engine&&) noexcept;
+		Engine& operator=(Engine&&) noexcept;
+		~Engine();
+
+		//blocks until the limits are reached or cancel is called. Analyses requested from several threads run one at a time.
+		Analysis analyze(const Position& pos, const SearchLimits& limits, AnalysisCallback onIteration = nullptr);
+		//history holds every position of the game so far, including pos, so that repetitions are scored as draws
+		Analysis analyze(const Position& pos, const RepetitionMap& history, const SearchLimits& limits, AnalysisCallback onIteration = nullptr);
+
+		//stops the running analysis, which then returns the deepest completed iteration. Analyses that were requested before
+		//the call but are still waiting for their turn are stopped as well. Safe to call from any thread.
+		void cancel();
+
+		//forgets the transposition table. Waits for the running analysis to finish.
+		void newGame();
+	};
+}
@@ -1,8 +1,8 @@
 module Chess.MeasureMoveTime;
 
-import std;
 import nlohmann.json;
 
+import Chess.Arena;
 import Chess.EnvironmentVariable;
 import Chess.Position;
 import Chess.Position.RepetitionMap;
@@ -10,116 +10,216 @@ import Chess.PositionCommand;
 import Chess.MoveSearch;
 import Chess.SafeInt;
 
-namespace std {
-	void to_json(nlohmann::json& j, const chrono::nanoseconds& ns) {
-		j = ns.count();
-	}
-	void from_json(const nlohmann::json& j, chrono::nanoseconds& ns) {
-		ns = chrono::nanoseconds{ j.get<std::chrono::nanoseconds::rep>() };
-	}
-}
-
 namespace chess {
+	//openings, a busy middlegame and an endgame, so that every phase contributes to the timings
+	constexpr std::array POSITION_INPUTS{
+		"fen rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+		"fen rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1",
+		"fen rnbqkbnr/pppppppp/8/8/3P4/8/PPP1PPPP/RNBQKBNR b KQkq - 0 1",
+		"fen r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"fen 8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+	};
+
 	std::vector<Position> getPositionInputs() {
-		constexpr auto POSITION_COUNT = 3uz;
-		const std::array<std::string, POSITION_COUNT> POSITION_INPUTS = {
-			"fen rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
-			"fen rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1",
-			"fen rnbqkbnr/pppppppp/8/8/3P4/8/PPP1PPPP/RNBQKBNR b KQkq - 0 1"
-		};
-		std::vector<Position> positions(POSITION_COUNT);
+		std::vector<Position> positions(POSITION_INPUTS.size());
 		for (const auto& [pos, fen] : std::views::zip(positions, POSITION_INPUTS)) {
 			pos.setPos(parsePositionCommand(fen));
 		}
 		return positions;
 	}
 
-	using namespace std::literals;
+	struct RunSample {
+		double milliseconds = 0.0;
+		std::uint64_t nodes = 0;
+	};
+
+	//searches every position once, each starting from an empty transposition table
+	RunSample measureRun(AsyncSearch& search, std::span<const Position> positions, SafeUnsigned<std::uint8_t> depth) {
+		RunSample ret;
+		for (const auto& pos : positions) {
+			clearTranspositionTable();
+			RepetitionMap repetitionMap;
+			repetitionMap.push(pos);
 
-	constexpr auto MAX_DEPTH = 8;
+			auto start = std::chrono::steady_clock::now();
+			search.findBestMove(pos, depth, repetitionMap);
+			auto end = std::chrono::steady_clock::now();
 
-	using AverageArray = std::array<std::chrono::nanoseconds, 32>; //average time with x pieces on the board
-	using DepthArray   = std::array<AverageArray, MAX_DEPTH - 1>; //average time with k depth and x pieces on the board
+			ret.milliseconds += std::chrono::duration<double, std::milli>{ end - start }.count();
+			ret.nodes += search.getStats().nodes;
+		}
+		return ret;
+	}
 
-	size_t calcPieceCount(const Position& pos) {
-		auto [white, black] = pos.getColorSides();
-		auto whitePieces = white.calcAllLocations();
-		auto blackPieces = black.calcAllLocations();
-		return static_cast<size_t>(std::popcount(whitePieces) + std::popcount(blackPieces));
+	double calcMean(std::span<const double> samples) {
+		return std::ranges::fold_left(samples, 0.0, std::plus{}) / static_cast<double>(samples.size());
 	}
 
-	void measureMoveTimeImpl(AverageArray& averageArray, AsyncSearch& search, SafeUnsigned<std::uint8_t> depth, const Position& startPos) {
-		clearTranspositionTable();
+	double calcMedian(std::vector<double> samples) {
+		std::ranges::sort(samples);
+		auto mid = samples.size() / 2;
+		return samples.size() % 2 == 0 ? (samples[mid - 1] + samples[mid]) / 2.0 : samples[mid];
+	}
 
-		std::ranges::fill(averageArray, 0ns);
+	double calcVariance(std::span<const double> samples) {
+		if (samples.size() < 2) {
+			return 0.0;
+		}
+		auto mean = calcMean(samples);
+		auto squaredDeviations = std::ranges::fold_left(samples, 0.0, [mean](double sum, double sample) {
+			return sum + (sample - mean) * (sample - mean);
+		});
+		return squaredDeviations / static_cast<double>(samples.size() - 1);
+	}
 
-		auto pos = startPos;
+	//two sided 95% critical value of Student's t distribution
+	double calcCriticalT(double degreesOfFreedom) {
+		constexpr std::array CRITICAL_VALUES{
+			12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+			2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+			2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+		};
+		auto index = static_cast<size_t>(std::max(std::floor(degreesOfFreedom), 1.0)) - 1;
+		return index < CRITICAL_VALUES.size() ? CRITICAL_VALUES[index] : 1.960;
+	}
 
-		RepetitionMap repetitionMap;
-		repetitionMap.push(pos);
+	nlohmann::json summarizeDepth(int depth, std::span<const RunSample> runs) {
+		auto times = runs | std::views::transform(&RunSample::milliseconds) | std::ranges::to<std::vector>();
+		auto nodes = runs | std::views::transform([](const RunSample& run) {
+			return static_cast<double>(run.nodes);
+		}) | std::ranges::to<std::vector>();
+
+		auto mean = calcMean(times);
+		auto standardDeviation = std::sqrt(calcVariance(times));
+		auto margin = calcCriticalT(static_cast<double>(times.size() - 1)) * standardDeviation / std::sqrt(static_cast<double>(times.size()));
+		auto medianTime = calcMedian(times);
+		auto medianNodes = calcMedian(nodes);
+
+		nlohmann::json ret;
+		ret["depth"] = depth;
+		ret["median_ms"] = medianTime;
+		ret["mean_ms"] = mean;
+		ret["stddev_ms"] = standardDeviation;
+		ret["ci95_low_ms"] = mean - margin;
+		ret["ci95_high_ms"] = mean + margin;
+		ret["median_nodes"] = static_cast<std::uint64_t>(medianNodes);
+		ret["nps"] = medianTime > 0.0 ? static_cast<std::uint64_t>(medianNodes * 1000.0 / medianTime) : 0;
+		ret["samples_ms"] = times;
+		return ret;
+	}
 
-		std::array<int, 32> moveCountsWithNPieces;
-		std::ranges::fill(moveCountsWithNPieces, 0);
+	//default output location, kept apart from the tracked assets so that measurements never overwrite them
+	std::filesystem::path getProfilingSessionPath(std::string_view fileName) {
+		auto sessionDirectory = getAssetDirectoryPath() / "profiling_sessions";
+		std::filesystem::create_directories(sessionDirectory);
+		return sessionDirectory / fileName;
+	}
 
-		while (true) {
-			auto pieceCount = calcPieceCount(pos);
+	void measureMoveTime(const MoveTimeOptions& options) {
+		AsyncSearch search;
+		auto positions = getPositionInputs();
 
-			auto start = std::chrono::steady_clock::now();
-			auto bestMove = search.findBestMove(pos, depth, repetitionMap);
-			if (!bestMove) {
-				break;
-			}
+		nlohmann::json output;
+		output["warmup_runs"] = options.warmupRuns;
+		output["measured_runs"] = options.measuredRuns;
+		output["positions"] = POSITION_INPUTS;
+		output["depths"] = nlohmann::json::array();
 
-			//update the position
-			pos.move(*bestMove);
-			repetitionMap.push(pos);
+		for (int depth = 1; depth <= options.maxDepth; depth++) {
+			SafeUnsigned searchDepth{ static_cast<std::uint8_t>(depth) };
+			for (int i = 0; i < options.warmupRuns; i++) {
+				measureRun(search, positions, searchDepth);
+			}
 
-			auto end = std::chrono::steady_clock::now();
+			std::vector<RunSample> runs;
+			for (int i = 0; i < options.measuredRuns; i++) {
+				runs.push_back(measureRun(search, positions, searchDepth));
+			}
 
-			auto timeSpent = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-			averageArray[pieceCount - 1] += timeSpent;
-			moveCountsWithNPieces[pieceCount - 1]++;
+			auto summary = summarizeDepth(depth, runs);
+			std::println("Depth {}: mean {:.2f}ms, 95% CI [{:.2f}, {:.2f}]ms, median {:.2f}ms, {} nodes, {} nps", depth, summary["mean_ms"].get<double>(),
+				summary["ci95_low_ms"].get<double>(), summary["ci95_high_ms"].get<double>(), summary["median_ms"].get<double>(),
+				summary["median_nodes"].get<std::uint64_t>(), summary["nps"].get<std::uint64_t>());
+			output["depths"].push_back(summary);
 		}
 
-		for (auto [average, moveCount] : std::views::zip(averageArray, moveCountsWithNPieces)) {
-			if (moveCount > 0) {
-				average /= moveCount;
-			}
-		}
+		auto path = options.outputPath.empty() ? getProfilingSessionPath("move_times.json") : options.outputPath;
+		std::ofstream file{ path };
+		file << output.dump(2);
+		std::println("Wrote move times to {}", path.string());
 	}
 
-	void calcAverageTimeDecrease(const AverageArray& averageArray, SafeUnsigned<std::uint8_t> depth) {
-		auto ret = 0ns;
+	void measureSearchAnalytics(const SearchAnalyticsOptions& options) {
+		arena::registerThread(std::this_thread::get_id());
+		IsolatedSearch search;
+		SearchAnalytics analytics;
+		search.setAnalytics(&analytics);
+
+		SearchLimits limits;
+		limits.depth = SafeUnsigned{ static_cast<std::uint8_t>(options.depth) };
+		for (const auto& pos : getPositionInputs()) {
+			search.clearPositionTable();
+			RepetitionMap repetitionMap;
+			repetitionMap.push(pos);
+			search.search(pos, repetitionMap, limits);
+		}
+		search.setAnalytics(nullptr);
 
-		auto reversePairs = std::views::reverse(averageArray) | std::views::adjacent<2>;
-		int pieceCount = 32;
+		auto path = options.outputPath.empty() ? getProfilingSessionPath("search_analytics.json") : options.outputPath;
+		writeSearchAnalytics(analytics, path);
+		std::println("Wrote search analytics for {} positions at depth {} to {}", POSITION_INPUTS.size(), options.depth, path.string());
+	}
 
-		for (const auto [t1, t2] : reversePairs) {
-			auto change = t1 - t2;
-			std::println("Change from {} to {} pieces at depth {}: {}", pieceCount, pieceCount - 1, static_cast<std::uint32_t>(depth.get()),change);
-			pieceCount--;
+	nlohmann::json loadMoveTimes(const std::filesystem::path& path) {
+		std::ifstream file{ path };
+		if (!file.is_open()) {
+			std::println("Error: could not open {}", path.string());
+			std::exit(-1);
 		}
+		return nlohmann::json::parse(file);
 	}
 
-	void measureMoveTime() {
-		AsyncSearch search;
-		DepthArray depthArray{};
+	bool compareMoveTimes(const std::filesystem::path& baselinePath, const std::filesystem::path& candidatePath) {
+		auto baseline = loadMoveTimes(baselinePath);
+		auto candidate = loadMoveTimes(candidatePath);
+		if (baseline["positions"] != candidate["positions"]) {
+			std::println("Warning: the results were measured on different positions");
+		}
 
-		auto positions = getPositionInputs();
-		for (auto depth = 1_su8; depth < SafeUnsigned<std::uint8_t>{ MAX_DEPTH }; ++depth) {
-			std::println("Measuring depth {}", static_cast<std::uint32_t>(depth.get()));
+		bool hasRegression = false;
+		std::println("{:>5} {:>12} {:>12} {:>8} {:>7}  verdict", "depth", "base mean ms", "new mean ms", "change", "t");
+		for (const auto& baseDepth : baseline["depths"]) {
+			auto depth = baseDepth["depth"].get<int>();
+			auto candidateDepth = std::ranges::find_if(candidate["depths"], [depth](const nlohmann::json& j) {
+				return j["depth"].get<int>() == depth;
+			});
+			if (candidateDepth == candidate["depths"].end()) {
+				continue;
+			}
 
-			auto& averageArray = depthArray[(depth - 1_su8).get()];
-			for (const auto& [i, pos]: std::views::enumerate(positions)) {
-				std::println("[{}]...", i);
-				measureMoveTimeImpl(averageArray, search, depth, pos);
+			//Welch's t-test, since the two builds needn't have the same variance. It compares means, so those are what's reported
+			auto baseSamples = baseDepth["samples_ms"].get<std::vector<double>>();
+			auto candidateSamples = (*candidateDepth)["samples_ms"].get<std::vector<double>>();
+			if (baseSamples.size() < 2 || candidateSamples.size() < 2) {
+				continue;
 			}
-			
-			calcAverageTimeDecrease(averageArray, depth);
+			auto baseError = calcVariance(baseSamples) / static_cast<double>(baseSamples.size());
+			auto candidateError = calcVariance(candidateSamples) / static_cast<double>(candidateSamples.size());
+			auto baseMean = calcMean(baseSamples);
+			auto candidateMean = calcMean(candidateSamples);
+			auto meanDifference = candidateMean - baseMean;
+			auto standardError = std::sqrt(baseError + candidateError);
+			auto t = standardError > 0.0 ? meanDifference / standardError : 0.0;
+			auto degreesOfFreedom = standardError > 0.0 ? std::pow(baseError + candidateError, 2.0) / 
+				(baseError * baseError / static_cast<double>(baseSamples.size() - 1) + candidateError * candidateError / static_cast<double>(candidateSamples.size() - 1)) : 1.0;
+
+			auto isSignificant = std::abs(t) > calcCriticalT(degreesOfFreedom);
+			auto verdict = !isSignificant ? "no significant change" : (t > 0.0 ? "REGRESSION" : "improvement");
+			hasRegression = hasRegression || (isSignificant && t > 0.0);
+
+			auto change = baseMean > 0.0 ? 100.0 * meanDifference / baseMean : 0.0;
+			std::println("{:>5} {:>12.2f} {:>12.2f} {:>+7.1f}% {:>7.2f}  {}", depth, baseMean, candidateMean, change, t, verdict);
 		}
-
-		nlohmann::json j = depthArray;
-		std::ofstream file{ getAssetDirectoryPath() / "depth_time.json" };
-		file << j.dump(2);
+		return !hasRegression;
 	}
-}
\ No newline at end of file
+}
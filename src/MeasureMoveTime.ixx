@@ -1,5 +1,26 @@
 export module Chess.MeasureMoveTime;
 
+import std;
+
 export namespace chess {
-	void measureMoveTime();
-}
\ No newline at end of file
+	struct MoveTimeOptions {
+		int maxDepth = 7;
+		int warmupRuns = 1;
+		int measuredRuns = 10;
+		std::filesystem::path outputPath; //defaults to move_times.json in the profiling sessions directory
+	};
+
+	//times searches of a fixed set of positions at every depth, writing the samples and their statistics to JSON
+	void measureMoveTime(const MoveTimeOptions& options);
+
+	struct SearchAnalyticsOptions {
+		int depth = 7;
+		std::filesystem::path outputPath; //defaults to search_analytics.json in the profiling sessions directory
+	};
+
+	//searches the same positions as measureMoveTime on a single thread, recording the shape of the search tree at each ply
+	void measureSearchAnalytics(const SearchAnalyticsOptions& options);
+
+	//compares two measureMoveTime results depth by depth. Returns false if the candidate has a statistically significant regression.
+	bool compareMoveTimes(const std::filesystem::path& baselinePath, const std::filesystem::path& candidatePath);
+}
@@ -0,0 +1,131 @@
+module;
+
+#ifdef _WIN64
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+module Chess.MemoryMappedFile;
+
+namespace chess {
+#ifdef _WIN64
+	std::optional<std::string> MemoryMappedFile::map(const std::filesystem::path& path) {
+		m_fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (m_fileHandle == INVALID_HANDLE_VALUE) {
+			return std::format("could not open {}: {}", path.string(), GetLastError());
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(m_fileHandle, &fileSize)) {
+			return std::format("could not read the size of {}: {}", path.string(), GetLastError());
+		}
+		m_size = static_cast<size_t>(fileSize.QuadPart);
+		if (m_size == 0) { //empty files can't be mapped
+			return std::nullopt;
+		}
+
+		m_mappingHandle = CreateFileMappingW(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_mappingHandle) {
+			return std::format("could not map {}: {}", path.string(), GetLastError());
+		}
+		m_data = static_cast<const char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+		if (!m_data) {
+			return std::format("could not map {}: {}", path.string(), GetLastError());
+		}
+		return std::nullopt;
+	}
+
+	void MemoryMappedFile::unmap() {
+		if (m_data) {
+			UnmapViewOfFile(m_data);
+		}
+		if (m_mappingHandle) {
+			CloseHandle(m_mappingHandle);
+		}
+		if (m_fileHandle && m_fileHandle != INVALID_HANDLE_VALUE) {
+			CloseHandle(m_fileHandle);
+		}
+	}
+
+	void MemoryMappedFile::swap(MemoryMappedFile& other) noexcept {
+		std::swap(m_data, other.m_data);
+		std::swap(m_size, other.m_size);
+		std::swap(m_fileHandle, other.m_fileHandle);
+		std::swap(m_mappingHandle, other.m_mappingHandle);
+	}
+#else
+	std::optional<std::string> MemoryMappedFile::map(const std::filesystem::path& path) {
+		m_fd = open(path.c_str(), O_RDONLY);
+		if (m_fd == -1) {
+			return std::format("could not open {}", path.string());
+		}
+
+		struct stat fileStat;
+		if (fstat(m_fd, &fileStat) == -1) {
+			return std::format("could not read the size of {}", path.string());
+		}
+		if (!S_ISREG(fileStat.st_mode)) { //directories open fine, but can't be mapped
+			return std::format("{} is not a regular file", path.string());
+		}
+		m_size = static_cast<size_t>(fileStat.st_size);
+		if (m_size == 0) { //empty files can't be mapped
+			return std::nullopt;
+		}
+
+		auto mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+		if (mapping == MAP_FAILED) {
+			return std::format("could not map {}", path.string());
+		}
+		madvise(mapping, m_size, MADV_SEQUENTIAL);
+		m_data = static_cast<const char*>(mapping);
+		return std::nullopt;
+	}
+
+	void MemoryMappedFile::unmap() {
+		if (m_data) {
+			munmap(const_cast<char*>(m_data), m_size);
+		}
+		if (m_fd != -1) {
+			close(m_fd);
+		}
+	}
+
+	void MemoryMappedFile::swap(MemoryMappedFile& other) noexcept {
+		std::swap(m_data, other.m_data);
+		std::swap(m_size, other.m_size);
+		std::swap(m_fd, other.m_fd);
+	}
+#endif
+
+	MemoryMappedFile::MemoryMappedFile(const std::filesystem::path& path) {
+		if (auto error = map(path)) {
+			std::println("Error: {}", *error);
+			std::exit(-1);
+		}
+	}
+
+	std::expected<MemoryMappedFile, std::string> MemoryMappedFile::tryOpen(const std::filesystem::path& path) {
+		MemoryMappedFile ret;
+		if (auto error = ret.map(path)) {
+			return std::unexpected{ std::move(*error) };
+		}
+		return ret;
+	}
+
+	MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept {
+		swap(other);
+	}
+
+	MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept {
+		swap(other); //other unmaps what this held when it is destroyed
+		return *this;
+	}
+
+	MemoryMappedFile::~MemoryMappedFile() {
+		unmap();
+	}
+}
@@ -0,0 +1,42 @@
+export module Chess.MemoryMappedFile;
+
+import std;
+
+export namespace chess {
+	//read-only view of a whole file
+	class MemoryMappedFile {
+	private:
+		const char* m_data = nullptr;
+		size_t m_size = 0;
+#ifdef _WIN64
+		void* m_fileHandle = nullptr;
+		void* m_mappingHandle = nullptr;
+#else
+		int m_fd = -1;
+#endif
+		MemoryMappedFile() = default;
+
+		//returns the error message if the file couldn't be opened or mapped
+		std::optional<std::string> map(const std::filesystem::path& path);
+		void unmap();
+		void swap(MemoryMappedFile& other) noexcept;
+	public:
+		//exits if the file can't be mapped, for command line tools that can't continue without it
+		explicit MemoryMappedFile(const std::filesystem::path& path);
+		//for callers that must keep running, e.g. the engine loading a file a GUI named
+		static std::expected<MemoryMappedFile, std::string> tryOpen(const std::filesystem::path& path);
+
+		MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+		MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept;
+		MemoryMappedFile(const MemoryMappedFile&) = delete;
+		MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+		~MemoryMappedFile();
+
+		std::string_view getText() const {
+			return { m_data, m_size };
+		}
+		std::span<const std::byte> getBytes() const {
+			return { reinterpret_cast<const std::byte*>(m_data), m_size };
+		}
+	};
+}
@@ -0,0 +1,154 @@
+module Chess.Microbenchmarks;
+
+import Chess.Arena;
+import Chess.Benchmark;
+import Chess.Evaluation;
+import Chess.MoveGeneration;
+import Chess.MoveSearch;
+import Chess.PerfCounters;
+import Chess.Position;
+import Chess.Position.RepetitionMap;
+import Chess.PositionCommand;
+import Chess.SafeInt;
+
+namespace chess {
+	//every game phase, plus the standard perft positions for their unusual castling, en passant and pin cases
+	constexpr std::array CORPUS_INPUTS{
+		"fen rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+		"fen rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1",
+		"fen r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+		"fen r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"fen r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+		"fen rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+		"fen 2r3k1/pp3ppp/4p3/3pP3/3P4/P4N2/1P3PPP/2R3K1 b - - 3 24",
+		"fen 8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+		"fen 8/8/4k3/8/2p5/8/B2K4/8 w - - 0 50",
+		"fen 6k1/5p2/6p1/8/7p/8/6PP/6K1 b - - 0 40"
+	};
+
+	std::vector<Position> getCorpus() {
+		std::vector<Position> corpus(CORPUS_INPUTS.size());
+		for (const auto& [pos, fen] : std::views::zip(corpus, CORPUS_INPUTS)) {
+			pos.setPos(parsePositionCommand(fen));
+		}
+		return corpus;
+	}
+
+	void benchmarkPositionMove(MicrobenchmarkRunner& runner, std::span<const Position> corpus) {
+		auto offset = arena::getMemoryRegion()->getOffset();
+		auto firstMoves = corpus | std::views::transform([](const Position& pos) {
+			return calcPositionData(pos).legalMoves.front();
+		}) | std::ranges::to<std::vector>();
+		arena::getMemoryRegion()->resetToOffset(offset);
+
+		runner.run("Position::move", [&] {
+			for (const auto& [pos, move] : std::views::zip(corpus, firstMoves)) {
+				Position child{ pos, move };
+				doNotOptimize(&child);
+			}
+		});
+	}
+
+	void benchmarkRepetitionMap(MicrobenchmarkRunner& runner, std::span<const Position> corpus) {
+		RepetitionMap repetitionMap;
+		runner.run("RepetitionMap::push", [&] {
+			for (const auto& pos : corpus) {
+				repetitionMap.push(pos);
+			}
+		});
+		repetitionMap.clear();
+
+		//pushes are needed to have something to pop, so this is the cost of a push and pop pair
+		runner.run("RepetitionMap::push + pop", [&] {
+			for (const auto& pos : corpus) {
+				repetitionMap.push(pos);
+			}
+			for (const auto& pos : corpus) {
+				repetitionMap.pop(pos);
+			}
+		});
+	}
+
+	void benchmarkEvaluation(MicrobenchmarkRunner& runner, std::span<const Position> corpus) {
+		auto offset = arena::getMemoryRegion()->getOffset();
+		{
+			//PositionData points into itself, so it has to be constructed in place instead of moved into a container
+			std::vector<std::unique_ptr<PositionData>> ownedPositionData;
+			for (const auto& pos : corpus) {
+				ownedPositionData.emplace_back(new PositionData(calcPositionData(pos)));
+			}
+			auto positionData = ownedPositionData | std::views::transform([](const auto& posData) -> const PositionData* {
+				return posData.get();
+			}) | std::ranges::to<std::vector>();
+
+			runner.run("staticEvaluation", [&] {
+				auto total = 0_rt;
+				for (auto [pos, posData] : std::views::zip(corpus, positionData)) {
+					total += staticEvaluation(pos, *posData);
+				}
+				doNotOptimize(&total);
+			});
+			benchmarks::runInternalEvaluationBenchmarks(runner, corpus, positionData);
+		}
+		arena::getMemoryRegion()->resetToOffset(offset);
+	}
+
+	//walks every depth down to zero the way Searcher and MovePriority::trim do, in the given SafeUnsigned profile
+	template<bool Checked>
+	void benchmarkDepthArithmetic(MicrobenchmarkRunner& runner, std::span<const std::uint8_t> startingDepths, std::string_view name) {
+		using Depth = SafeUnsigned<std::uint8_t, Checked>;
+		runner.run(name, [&] {
+			std::uint64_t total = 0;
+			for (auto startingDepth : startingDepths) {
+				Depth depth{ startingDepth };
+				Depth level{ 0 };
+				while (depth > Depth{ 0 }) {
+					--depth;
+					++level;
+					auto reducedDepth = depth;
+					reducedDepth.subToMin(Depth{ 2 }, Depth{ 0 });
+					total += (reducedDepth + level).get();
+				}
+			}
+			doNotOptimize(&total);
+		});
+	}
+
+	//the difference between the two profiles is the cost of SafeUnsigned's contracts in a checked build
+	void benchmarkSafeUnsignedProfiles() {
+		std::vector<std::uint8_t> startingDepths;
+		for (std::uint8_t depth = 1; depth <= MAX_SEARCH_DEPTH.get(); depth++) {
+			startingDepths.push_back(depth);
+		}
+
+		MicrobenchmarkRunner runner{ startingDepths.size() };
+		benchmarkDepthArithmetic<true>(runner, startingDepths, "SafeUnsigned depth walk (checked)");
+		benchmarkDepthArithmetic<false>(runner, startingDepths, "SafeUnsigned depth walk (unchecked)");
+		runner.printResults();
+	}
+
+	void runMicrobenchmarks() {
+		arena::registerThread(std::this_thread::get_id());
+		auto corpus = getCorpus();
+
+		perf::setEnabled(true);
+		if (!perf::isAvailable()) {
+			std::println("Hardware counters are unavailable (Linux only, and perf_event_paranoid must allow user space counting)");
+		}
+
+		std::println("Measuring {} positions...", corpus.size());
+		MicrobenchmarkRunner runner{ corpus.size() };
+		benchmarks::runInternalMoveGenerationBenchmarks(runner, corpus);
+		benchmarkPositionMove(runner, corpus);
+		benchmarkRepetitionMap(runner, corpus);
+		benchmarkEvaluation(runner, corpus);
+		benchmarks::runInternalMoveSearchBenchmarks(runner, corpus);
+		runner.printResults();
+
+		std::println("");
+		benchmarks::runPositionTableBenchmarks(corpus);
+
+		std::println("");
+		benchmarkSafeUnsignedProfiles();
+	}
+}
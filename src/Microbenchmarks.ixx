@@ -0,0 +1,8 @@
+export module Chess.Microbenchmarks;
+
+import std;
+
+export namespace chess {
+	//times the engine's hot primitives over a fixed set of positions, printing ns/op and cycles/op. One op is one position.
+	void runMicrobenchmarks();
+}
@@ -0,0 +1,74 @@
+module Chess.MoveGeneration:InternalBenchmarks;
+
+import Chess.Arena;
+
+import :LegalMoveGeneration;
+import :PieceAttackers;
+import :SlidingMoveGenerators;
+
+namespace chess {
+	namespace benchmarks {
+		struct SlidingPieces {
+			Bitboard diagonal = 0;
+			Bitboard orthogonal = 0;
+			Bitboard empty = 0;
+		};
+
+		template<typename MoveGenerator>
+		void benchmarkSlidingMoveGenerator(MicrobenchmarkRunner& runner, std::string_view name, std::span<const SlidingPieces> corpusPieces, 
+			MoveGenerator moveGenerator, Bitboard SlidingPieces::* movingPieces) 
+		{
+			runner.run(name, [&] {
+				Bitboard total = 0;
+				for (const auto& pieces : corpusPieces) {
+					auto moveGen = moveGenerator(pieces.*movingPieces, pieces.empty);
+					total ^= moveGen.all();
+				}
+				doNotOptimize(&total);
+			});
+		}
+
+		void runInternalMoveGenerationBenchmarks(MicrobenchmarkRunner& runner, std::span<const Position> corpus) {
+			runner.run("calcPositionData", [&] {
+				auto offset = arena::getMemoryRegion()->getOffset();
+				for (const auto& pos : corpus) {
+					auto posData = calcPositionData(pos);
+					doNotOptimize(&posData);
+				}
+				arena::getMemoryRegion()->resetToOffset(offset); //the legal move lists are allocated from the arena
+			});
+
+			runner.run("calcAttackers (king)", [&] {
+				Bitboard total = 0;
+				for (const auto& pos : corpus) {
+					auto turnData = pos.getTurnData();
+					auto empty = ~(turnData.allies.calcAllLocations() | turnData.enemies.calcAllLocations());
+					auto attackerData = calcAttackers(turnData.isWhite, turnData.enemies, empty, turnData.allies[King]);
+					total ^= attackerData.allRays();
+				}
+				doNotOptimize(&total);
+			});
+
+			auto corpusPieces = corpus | std::views::transform([](const Position& pos) {
+				auto [white, black] = pos.getColorSides();
+				auto all = white.calcAllLocations() | black.calcAllLocations();
+				return SlidingPieces{
+					white[Bishop] | white[Queen] | black[Bishop] | black[Queen],
+					white[Rook] | white[Queen] | black[Rook] | black[Queen],
+					~all
+				};
+			}) | std::ranges::to<std::vector>();
+
+			benchmarkSlidingMoveGenerator(runner, "bishopMoveGenerator", corpusPieces, bishopMoveGenerator, &SlidingPieces::diagonal);
+			benchmarkSlidingMoveGenerator(runner, "rookMoveGenerator", corpusPieces, rookMoveGenerator, &SlidingPieces::orthogonal);
+			runner.run("queenMoveGenerator", [&] {
+				Bitboard total = 0;
+				for (const auto& pieces : corpusPieces) {
+					auto moveGen = queenMoveGenerator(pieces.diagonal & pieces.orthogonal, pieces.empty);
+					total ^= moveGen.all();
+				}
+				doNotOptimize(&total);
+			});
+		}
+	}
+}
@@ -0,0 +1,12 @@
+export module Chess.MoveGeneration:InternalBenchmarks;
+
+export import std;
+export import Chess.Benchmark;
+export import Chess.Position;
+
+export namespace chess {
+	namespace benchmarks {
+		//the calling thread must be registered with the arena
+		void runInternalMoveGenerationBenchmarks(MicrobenchmarkRunner& runner, std::span<const Position> corpus);
+	}
+}
@@ -11,6 +11,7 @@ import std;
 import Chess.Assert;
 import Chess.BitboardImage;
 import Chess.PieceMap;
+import Chess.Profiler;
 import Chess.RankCalculator;
 
 import :ChainedMoveGenerator;
@@ -213,20 +214,19 @@ namespace chess {
 
 	template<bool DrawingBitboards>
 	PositionData calcAllLegalMovesImpl(const Position& pos) {
-		auto turnData = pos.getTurnData();
-
-		if (turnData.isWhite) {
+		if (pos.isWhite()) {
 			using MoveGenerator = MoveGeneratorImpl<true, WhitePawnMoveGenerator, WhitePawnAttackGenerator,
 				BlackPawnMoveGenerator, BlackPawnAttackGenerator, calcRank<8>(), DrawingBitboards>;
-			return MoveGenerator::calcAllLegalMoves(turnData);
+			return MoveGenerator::calcAllLegalMoves(pos.getTurnData<true>());
 		} else {
 			using MoveGenerator = MoveGeneratorImpl<false, BlackPawnMoveGenerator, BlackPawnAttackGenerator,
 				WhitePawnMoveGenerator, WhitePawnAttackGenerator, calcRank<1>(), DrawingBitboards>;
-			return MoveGenerator::calcAllLegalMoves(turnData);
+			return MoveGenerator::calcAllLegalMoves(pos.getTurnData<false>());
 		}
 	}
 	
 	PositionData calcPositionData(const Position& pos) {
+		profiler::ScopedZone zone{ profiler::Zone::MoveGeneration };
 		return calcAllLegalMovesImpl<false>(pos);
 	}
 	PositionData calcPositionDataAndDrawBitboards(const Position& pos) {
@@ -1,6 +1,7 @@
 export module Chess.MoveGeneration;
 
 export import :DestinationSquares;
+export import :InternalBenchmarks;
 export import :LegalMoveGeneration;
 export import :PieceAttackers;
 export import :TableStore;
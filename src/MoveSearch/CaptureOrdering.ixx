@@ -0,0 +1,57 @@
+export module Chess.MoveSearch:CaptureOrdering;
+
+import std;
+
+import Chess.Assert;
+export import Chess.Move;
+export import Chess.PieceMap;
+export import Chess.Square;
+
+export namespace chess {
+	//piece values that only capture ordering uses. Kings are never victims, and rank as the most expensive attacker.
+	constexpr PieceMap<std::int32_t> CAPTURE_ORDER_VALUES{ { { Pawn, 1 }, { Knight, 2 }, { Bishop, 3 }, { Rook, 4 }, { Queen, 5 }, { King, 6 } } };
+
+	//most valuable victim, least valuable attacker. Indexed by [attacker][victim], so that a more valuable victim always
+	//outranks a cheaper attacker.
+	constexpr auto MVV_LVA = [] {
+		PieceMap<PieceMap<std::int32_t>> ret;
+		for (auto attacker : ALL_PIECE_TYPES) {
+			for (auto victim : ALL_PIECE_TYPES) {
+				ret[attacker][victim] = CAPTURE_ORDER_VALUES[victim] * 8 - CAPTURE_ORDER_VALUES[attacker];
+			}
+		}
+		return ret;
+	}();
+
+	static_assert(MVV_LVA[Queen][Rook] > MVV_LVA[Pawn][Bishop]);
+	static_assert(MVV_LVA[Pawn][Knight] > MVV_LVA[Rook][Knight]);
+
+	//how well each capture has done at causing beta cutoffs, indexed by moved piece, target square and captured piece
+	class CaptureHistory {
+	public:
+		static constexpr std::int32_t MAX_VALUE = 1024;
+	private:
+		PieceMap<SquareMap<PieceMap<std::int16_t>>> m_table;
+
+		std::int16_t& getEntry(const Move& move) {
+			zAssert(move.capturedPiece != Piece::None);
+			return m_table[move.movedPiece][move.to][move.capturedPiece];
+		}
+	public:
+		std::int32_t get(const Move& move) const {
+			zAssert(move.capturedPiece != Piece::None);
+			return m_table[move.movedPiece][move.to][move.capturedPiece];
+		}
+
+		//entries move towards the sign of the bonus and slow down as they approach MAX_VALUE, so they never leave [-MAX_VALUE, MAX_VALUE]
+		void update(const Move& move, std::int32_t bonus) {
+			bonus = std::clamp(bonus, -MAX_VALUE, MAX_VALUE);
+			auto& entry = getEntry(move);
+			entry = static_cast<std::int16_t>(entry + bonus - entry * std::abs(bonus) / MAX_VALUE);
+		}
+
+		void clear() {
+			m_table = {};
+		}
+	};
+}
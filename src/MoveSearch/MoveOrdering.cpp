@@ -2,90 +2,53 @@ module Chess.MoveSearch:MoveOrdering;
 
 import Chess.Assert;
 import Chess.Rating;
-import Chess.Evaluation;
-import Chess.MoveGeneration;
+import Chess.Profiler;
 
 import :PositionTable;
 
 namespace chess {
-	struct PieceData {
-		Piece piece = Piece::None;
-		Square square = Square::None;
-	};
-
-	template<typename NonPVMoves>
-	auto orderCapturesAndEvasionsFirst(const PieceData& attackedPiece, const Position::ImmutableTurnData& turnData,
-		Bitboard empty, NonPVMoves& priorities)
-	{
-		auto attackerData = calcAttackers(turnData.isWhite, turnData.enemies, empty, makeBitboard(attackedPiece.square));
-		auto attackers = attackerData.attackers.calcAllLocations();
-
-		auto pieceRating = getPieceRating(attackedPiece.piece);
-		
-		return std::ranges::stable_partition(priorities, [&](const MovePriority& p) {
-			if (p.getExchangeRating() >= pieceRating) { //if we have a better capture, do it
-				return true;
-			}
-			auto toBoard = makeBitboard(p.getMove().to);
-
-			//if we are capturing one of the attackers or blocking it's rays
-			return static_cast<bool>(toBoard & attackers) || static_cast<bool>(toBoard & attackerData.rays);
-		});
-	}
-
-	std::generator<PieceData> getTargets(const PieceState& allies, Bitboard enemyDestSquares) {
-		constexpr std::array MOST_VALUABLE_PIECES{ Queen, Rook, Bishop, Knight, Pawn };
-		for (auto piece : MOST_VALUABLE_PIECES) {
-			auto attackedAllies = allies[piece] & enemyDestSquares;
-			if (!attackedAllies) {
-				continue;
-			}
-			auto currSquare = Square::None;
-			while (nextSquare(attackedAllies, currSquare)) {
-				co_yield{ piece, currSquare };
-			}
+	//moves are sorted by a single key. Every band is far wider than the keys inside it, so bands never overlap.
+	constexpr std::int32_t PV_MOVE_KEY = 1 << 30;
+	constexpr std::int32_t GOOD_NOISY_BAND = 1 << 24; //captures and promotions that don't lose material
+	constexpr std::int32_t KILLER_MOVE_KEY = 1 << 20;
+	constexpr std::int32_t QUIET_BAND = 0;
+	constexpr std::int32_t BAD_NOISY_BAND = -(1 << 24); //captures and promotions that hang the moved piece for less
+
+	constexpr std::int32_t MVV_LVA_WEIGHT = 64; //neighboring victims are 8 * MVV_LVA_WEIGHT apart, half of CaptureHistory::MAX_VALUE
+	constexpr auto QUIET_RATING_WEIGHT = 100_rt;
+
+	std::int32_t calcNoisyKey(const MovePriority& movePriority, const CaptureHistory& captureHistory) {
+		const auto& move = movePriority.getMove();
+		auto ret = movePriority.getExchangeRating() >= 0_rt ? GOOD_NOISY_BAND : BAD_NOISY_BAND;
+		if (move.capturedPiece != Piece::None) {
+			ret += MVV_LVA[move.movedPiece][move.capturedPiece] * MVV_LVA_WEIGHT + captureHistory.get(move);
 		}
-	}
-
-	template<typename NonMaterialMoves>
-	auto orderKillerMovesFirst(std::span<const Move> killerMoves, NonMaterialMoves& nonMaterialMoves) {
-		return std::ranges::partition(nonMaterialMoves, [&](const MovePriority& priority) {
-			return std::ranges::any_of(killerMoves, [&](const Move& move) {
-				return move == priority.getMove();
-			});
-		});
-	}
-
-	template<typename NonPVMoves>
-	auto orderCapturesAndEvasionsFirst(const Node& node, Bitboard allEnemySquares, NonPVMoves& movePriorities) {
-		std::ranges::subrange ret{ movePriorities.begin(), movePriorities.end() };
-
-		auto turnData = node.getPos().getTurnData();
-		
-		auto empty = ~(turnData.enemies.calcAllLocations() | turnData.allies.calcAllLocations());
-		for (auto attackedPiece : getTargets(turnData.allies, allEnemySquares)) {
-			auto [pp, end] = orderCapturesAndEvasionsFirst(attackedPiece, turnData, empty, ret);
-			ret = std::ranges::subrange{ pp, end };
+		if (move.promotionPiece != Piece::None) { //ranked as if the promoted piece had been captured
+			ret += MVV_LVA[Pawn][move.promotionPiece] * MVV_LVA_WEIGHT;
 		}
-
 		return ret;
 	}
 
-	//returns non-PV moves
-	auto movePVMoveToFront(arena::Vector<MovePriority>& priorities, Move pvMove) {
-		if (pvMove != Move::null()) {
-			auto pvMoveIt = std::ranges::find_if(priorities, [&](const MovePriority& p) {
-				return p.getMove() == pvMove;
-			});
-			if (pvMoveIt != priorities.end()) {
-				std::iter_swap(priorities.begin(), pvMoveIt);
-				return std::ranges::subrange{ std::next(priorities.begin()), priorities.end() };
-			}
+	std::int32_t calcOrderKey(const MovePriority& movePriority, const Move& pvMove, std::span<const Move> killerMoves,
+		const CaptureHistory& captureHistory)
+	{
+		const auto& move = movePriority.getMove();
+		if (move == pvMove) {
+			return PV_MOVE_KEY;
 		}
-		return std::ranges::subrange{ priorities.begin(), priorities.end() };
+		if (move.capturedPiece != Piece::None || move.promotionPiece != Piece::None) {
+			return calcNoisyKey(movePriority, captureHistory);
+		}
+		if (std::ranges::contains(killerMoves, move)) {
+			return KILLER_MOVE_KEY;
+		}
+		//quiet moves onto attacked squares have a negative exchange rating
+		return QUIET_BAND + static_cast<std::int32_t>(movePriority.getExchangeRating() * QUIET_RATING_WEIGHT);
 	}
 
-	arena::Vector<MovePriority> getMovePrioritiesImpl(const Node& node, const Move& pvMove, std::span<const Move> killerMoves) {
+	arena::Vector<MovePriority> getMovePrioritiesImpl(const Node& node, const Move& pvMove, std::span<const Move> killerMoves,
+		const CaptureHistory& captureHistory, const SearchParameters& parameters)
+	{
 		zAssert(node.getRemainingDepth() > 0_su8);
 
 		const auto& posData  = node.getPositionData();
@@ -93,22 +56,22 @@ namespace chess {
 
 		auto remainingDepth = node.getRemainingDepth();
 		arena::Vector<MovePriority> priorities{ std::from_range, posData.legalMoves | std::views::transform([&](const Move& move) {
-			return MovePriority{ move, allEnemySquares, remainingDepth };
+			MovePriority ret{ move, allEnemySquares, remainingDepth };
+			ret.setOrderKey(calcOrderKey(ret, pvMove, killerMoves, captureHistory));
+			return ret;
 		}) };
 
-		std::ranges::sort(priorities, [](const MovePriority& a, const MovePriority& b) {
-			return a.getExchangeRating() > b.getExchangeRating();
-		});
-
-		auto nonPVMoves = movePVMoveToFront(priorities, pvMove);
-		auto nonMaterialMoves = orderCapturesAndEvasionsFirst(node, allEnemySquares, nonPVMoves);
-		auto likelyBadMoves = orderKillerMovesFirst(killerMoves, nonMaterialMoves);
+		std::ranges::sort(priorities, std::greater{}, &MovePriority::getOrderKey);
 
 		if (remainingDepth - 1_su8 != 0_su8) {
-			auto baseOffset = std::ranges::distance(priorities.begin(), likelyBadMoves.begin());
-			for (auto&& [i, movePriority] : likelyBadMoves | std::views::enumerate) {
+			//everything ordered after the killer moves is likely bad, so it is searched at a reduced depth
+			auto likelyBadMoves = std::ranges::find_if(priorities, [](const MovePriority& p) {
+				return p.getOrderKey() < KILLER_MOVE_KEY;
+			});
+			auto baseOffset = std::ranges::distance(priorities.begin(), likelyBadMoves);
+			for (auto&& [i, movePriority] : std::ranges::subrange{ likelyBadMoves, priorities.end() } | std::views::enumerate) {
 				SafeUnsigned indexOffset{ static_cast<std::uint8_t>(baseOffset + i) };
-				movePriority.trim(indexOffset);
+				movePriority.trim(indexOffset, parameters);
 			}
 		}
 		
@@ -117,7 +80,10 @@ namespace chess {
 		return priorities;
 	}
 
-	arena::Vector<MovePriority> getMovePriorities(const Node& node, const Move& pvMove, std::span<const Move> killerMoves) {
-		return getMovePrioritiesImpl(node, pvMove, killerMoves);
+	arena::Vector<MovePriority> getMovePriorities(const Node& node, const Move& pvMove, std::span<const Move> killerMoves,
+		const CaptureHistory& captureHistory, const SearchParameters& parameters)
+	{
+		profiler::ScopedZone zone{ profiler::Zone::MoveOrdering };
+		return getMovePrioritiesImpl(node, pvMove, killerMoves, captureHistory, parameters);
 	}
 }
\ No newline at end of file
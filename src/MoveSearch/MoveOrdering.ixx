@@ -2,9 +2,11 @@ export module Chess.MoveSearch:MoveOrdering;
 
 export import Chess.Arena;
 export import Chess.Move;
+export import :CaptureOrdering;
 export import :MovePriority;
 export import :Node;
 
 export namespace chess {
-	arena::Vector<MovePriority> getMovePriorities(const Node& node, const Move& pvMove, std::span<const Move> killerMoves);
+	arena::Vector<MovePriority> getMovePriorities(const Node& node, const Move& pvMove, std::span<const Move> killerMoves,
+		const CaptureHistory& captureHistory, const SearchParameters& parameters);
 }
\ No newline at end of file
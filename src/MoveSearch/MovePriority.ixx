@@ -7,6 +7,7 @@ export import Chess.Evaluation;
 export import Chess.Move;
 export import Chess.SafeInt;
 export import Chess.Rating;
+export import :SearchParameters;
 
 namespace chess {
 	Rating calcExchangeRating(const Move& m, Bitboard enemySquares) {
@@ -29,6 +30,7 @@ namespace chess {
 		Move m_move;
 		Rating m_exchangeRating = 0_rt;
 		SafeUnsigned<std::uint8_t> m_recommendedDepth{ 0 };
+		std::int32_t m_orderKey = 0; //moves are searched from the highest key to the lowest
 		bool m_trimmed = false;
 	public:
 		MovePriority() = default;
@@ -53,13 +55,13 @@ namespace chess {
 			return table;
 		}
 	public:
-		void trim(SafeUnsigned<std::uint8_t> moveIndex) {
+		void trim(SafeUnsigned<std::uint8_t> moveIndex, const SearchParameters& parameters) {
 			m_trimmed = true;
 
 			static const auto LOG_TABLE = makeLog2Table();
 			auto logDepth = LOG_TABLE[(m_recommendedDepth + 1_su8).get()];
 			auto logI = LOG_TABLE[(moveIndex + 1_su8).get()];
-			SafeUnsigned reducedDepth{ static_cast<std::uint8_t>(0.99 + (logDepth * logI / 3.14)) }; //add 0.5 to round up
+			SafeUnsigned reducedDepth{ static_cast<std::uint8_t>(parameters.lmrBase + (logDepth * logI / parameters.lmrDivisor)) };
 
 			auto subbed = m_recommendedDepth + 1_su8; //m_recommended depth is actually the original depth - 1
 			subbed.subToMin(reducedDepth, 0_su8);
@@ -80,6 +82,12 @@ namespace chess {
 		Rating getExchangeRating() const {
 			return m_exchangeRating;
 		}
+		std::int32_t getOrderKey() const {
+			return m_orderKey;
+		}
+		void setOrderKey(std::int32_t orderKey) {
+			m_orderKey = orderKey;
+		}
 		std::string getString() const {
 			return std::format("[{}, {}]", m_move.getUCIString(), static_cast<unsigned int>(m_recommendedDepth.get()));
 		}
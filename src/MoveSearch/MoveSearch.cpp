@@ -5,7 +5,6 @@ module;
 module Chess.MoveSearch;
 
 import std;
-import BS.thread_pool;
 
 import Chess.Arena;
 import Chess.Assert;
@@ -13,6 +12,8 @@ import Chess.DebugPrint;
 import Chess.EasyRandom;
 import Chess.Evaluation;
 import Chess.MoveGeneration;
+import Chess.PerfCounters;
+import Chess.Profiler;
 import Chess.Position.RepetitionMap;
 import Chess.Rating;
 
@@ -20,6 +21,7 @@ import :MoveOrdering;
 import :MoveHasher;
 import :Node;
 import :PositionTable;
+import :SearchThreads;
 
 namespace chess {
 	class AlphaBeta {
@@ -55,6 +57,13 @@ namespace chess {
 		}
 	};
 
+	//PV nodes lie on the principal variation of their parent: the root and the first child of every PV node. Both types are
+	//searched the same way for now; the type is a template parameter so that PV-only logic can be kept out of NonPV nodes.
+	enum class NodeType : std::uint8_t {
+		PV,
+		NonPV
+	};
+
 	struct MoveRating {
 		Move move = Move::null();
 		Rating rating = 0_rt;
@@ -62,25 +71,95 @@ namespace chess {
 		std::optional<SafeUnsigned<std::uint8_t>> checkmateLevel = std::nullopt;
 	};
 
+	//each searcher only writes its own counters, so they don't need atomic read-modify-writes. They are atomic so that
+	//other threads can read them mid-search, and padded so that searchers don't share cache lines.
+	struct alignas(std::hardware_destructive_interference_size) SearchCounters {
+		std::atomic<std::uint64_t> nodes = 0;
+		std::atomic<std::uint64_t> leafNodes = 0;
+		std::atomic<std::uint64_t> positionTableHits = 0;
+		std::atomic<std::uint64_t> betaCutoffs = 0;
+		std::atomic<std::uint64_t> firstMoveCutoffs = 0;
+		std::atomic<std::uint64_t> lmrResearches = 0;
+		std::atomic<std::uint8_t> selectiveDepth = 0;
+		std::array<std::atomic<std::uint64_t>, perf::EVENT_COUNT> hardware{}; //updated once per search
+
+		static void increment(std::atomic<std::uint64_t>& counter) {
+			counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
+		void updateSelectiveDepth(SafeUnsigned<std::uint8_t> level) {
+			if (level.get() > selectiveDepth.load(std::memory_order_relaxed)) {
+				selectiveDepth.store(level.get(), std::memory_order_relaxed);
+			}
+		}
+
+		void reset() {
+			for (auto counter : { &nodes, &leafNodes, &positionTableHits, &betaCutoffs, &firstMoveCutoffs, &lmrResearches }) {
+				counter->store(0, std::memory_order_relaxed);
+			}
+			selectiveDepth.store(0, std::memory_order_relaxed);
+			for (auto& counter : hardware) {
+				counter.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		void storeHardware(const perf::CounterValues& values) {
+			for (auto&& [counter, value] : std::views::zip(hardware, values.values)) {
+				counter.store(value, std::memory_order_relaxed);
+			}
+		}
+
+		SearchStats load() const {
+			SearchStats ret{
+				nodes.load(std::memory_order_relaxed),
+				leafNodes.load(std::memory_order_relaxed),
+				positionTableHits.load(std::memory_order_relaxed),
+				betaCutoffs.load(std::memory_order_relaxed),
+				firstMoveCutoffs.load(std::memory_order_relaxed),
+				lmrResearches.load(std::memory_order_relaxed),
+				selectiveDepth.load(std::memory_order_relaxed)
+			};
+			for (auto&& [value, counter] : std::views::zip(ret.hardware.values, hardware)) {
+				value = counter.load(std::memory_order_relaxed);
+			}
+			return ret;
+		}
+	};
+
 	class Searcher {
 	private:
-		static constexpr SafeUnsigned<std::uint8_t> RANDOMIZATION_CUTOFF{ 3 };
 		std::mt19937 m_urbg;
 		bool m_helper = false;
 		const std::atomic_bool* m_stopRequested;
+		PositionTable* m_positionTable;
 
-		static constexpr auto MAX_DEPTH = 30uz;
-		static constexpr auto MAX_KILLER_MOVES = 3uz;
+		static constexpr std::uint64_t TIME_CHECK_INTERVAL = 1024;
+		std::unique_ptr<SearchCounters> m_counters = std::make_unique<SearchCounters>(); //heap allocated, so that searchers stay movable
+		std::uint64_t m_stopPolls = 0;
+		std::uint64_t m_nodeLimit = std::numeric_limits<std::uint64_t>::max();
+		std::chrono::steady_clock::time_point m_deadline = std::chrono::steady_clock::time_point::max();
+		bool m_enforceLimits = false; //limits are only enforced once the first iteration has finished, so that there is always a move to play
+		bool m_limitReached = false;
+
+		std::optional<std::pair<SafeUnsigned<std::uint8_t>, MoveRating>> m_lastCompletedIteration;
+		std::move_only_function<void(SafeUnsigned<std::uint8_t>, const MoveRating&)> m_onIteration;
+
+		static constexpr auto MAX_DEPTH = static_cast<size_t>(MAX_SEARCH_DEPTH.get()) + 1;
 		struct KillerMoveEntries {
-			std::array<Move, MAX_KILLER_MOVES> killerMoves{};
+			std::array<Move, SearchParameters::MAX_KILLER_MOVES> killerMoves{};
 			size_t index = 0;
 		};
 		std::array<KillerMoveEntries, MAX_DEPTH> m_killerMoves{};
+		CaptureHistory m_captureHistory;
+
+		SearchParameters m_parameters;
+
+		SearchAnalytics* m_analytics = nullptr;
 	public:
 		SafeUnsigned<std::uint8_t> depth = 0_su8;
 
-		Searcher(bool helper, const std::atomic_bool* stopRequested)
-			: m_urbg{ std::random_device{}() }, m_helper{ helper }, m_stopRequested{ stopRequested }
+		Searcher(bool helper, const std::atomic_bool* stopRequested, PositionTable* positionTable)
+			: m_urbg{ std::random_device{}() }, m_helper{ helper }, m_stopRequested{ stopRequested }, m_positionTable{ positionTable }
 		{
 			for (auto& killerMoves : m_killerMoves) {
 				std::ranges::fill(killerMoves.killerMoves, Move::null());
@@ -109,15 +188,97 @@ namespace chess {
 		bool isHelper() const {
 			return m_helper;
 		}
+
+		void setLimits(const SearchLimits& limits, std::chrono::steady_clock::time_point start) {
+			depth = std::min(limits.depth, MAX_SEARCH_DEPTH);
+			m_nodeLimit = limits.nodes.value_or(std::numeric_limits<std::uint64_t>::max());
+			m_deadline = limits.moveTime ? start + *limits.moveTime : std::chrono::steady_clock::time_point::max();
+		}
+
+		//only call between searches
+		void setParameters(const SearchParameters& parameters) {
+			zAssert(parameters.killerMoves >= 1 && parameters.killerMoves <= SearchParameters::MAX_KILLER_MOVES);
+			m_parameters = parameters;
+			for (auto& killerMoves : m_killerMoves) {
+				std::ranges::fill(killerMoves.killerMoves, Move::null());
+				killerMoves.index = 0;
+			}
+			m_captureHistory.clear();
+		}
+
+		void setIterationCallback(std::move_only_function<void(SafeUnsigned<std::uint8_t>, const MoveRating&)> onIteration) {
+			m_onIteration = std::move(onIteration);
+		}
+
+		std::uint64_t getNodeCount() const {
+			return m_counters->nodes.load(std::memory_order_relaxed);
+		}
+
+		SearchStats getStats() const {
+			return m_counters->load();
+		}
+
+		void resetStats() {
+			m_counters->reset();
+		}
+
+		const auto& getLastCompletedIteration() const {
+			return m_lastCompletedIteration;
+		}
+
+		//nullptr stops collecting analytics
+		void setAnalytics(SearchAnalytics* analytics) {
+			m_analytics = analytics;
+			if (m_analytics) {
+				m_analytics->plies.resize(MAX_DEPTH); //sized up front, so plies can be referenced while deeper plies are updated
+			}
+		}
 	private:
+		PlyAnalytics* getPlyAnalytics(const Node& node) {
+			return m_analytics ? &m_analytics->plies[node.getLevel().get()] : nullptr;
+		}
+
+		bool isStopped() const {
+			return m_limitReached || m_stopRequested->load();
+		}
+
+		bool pollStop() {
+			if (m_enforceLimits && !m_limitReached) {
+				if (getNodeCount() >= m_nodeLimit) {
+					m_limitReached = true;
+				} else if (++m_stopPolls % TIME_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= m_deadline) {
+					m_limitReached = true;
+				}
+			}
+			return isStopped();
+		}
+
+		MoveRating completeIteration(SafeUnsigned<std::uint8_t> iterDepth, const MoveRating& rating) {
+			if (!isStopped()) {
+				m_lastCompletedIteration = std::pair{ iterDepth, rating };
+				m_enforceLimits = true;
+				if (m_onIteration) {
+					m_onIteration(iterDepth, rating);
+				}
+			}
+			return rating;
+		}
+
 		static bool wouldMakeRepetition(const Position& pos, Move pvMove, const RepetitionMap& repetitionMap) {
 			Position child{ pos, pvMove };
 			auto repetitionCount = repetitionMap.getPositionCount(child) + 1; //add 1 since we haven't actually pushed this position yet
 			return repetitionCount >= 2; //return 2 (not 3) because the opposing player could then make a threefold repetition after this
 		}
 
-		template<bool Maximizing>
+		template<bool Maximizing, NodeType Type>
 		MoveRating tryShortCircuit(const Node& node, AlphaBeta alphaBeta) {
+			SearchCounters::increment(m_counters->nodes);
+			m_counters->updateSelectiveDepth(node.getLevel());
+			auto plyAnalytics = getPlyAnalytics(node);
+			if (plyAnalytics) {
+				plyAnalytics->nodes++;
+			}
+
 			if (node.getPositionData().legalMoves.empty()) {
 				MoveRating ret;
 
@@ -134,15 +295,19 @@ namespace chess {
 
 			auto pvMove = Move::null();
 
-			if (m_stopRequested->load()) {
+			if (pollStop()) {
 				return { Move::null(), node.getRating(), false };
 			}
 
 			bool canUseEntry = !(m_helper && node.getLevel() == 0_su8);
 
-			if (!m_stopRequested->load() && canUseEntry) {
-				if (auto entryRes = getPositionEntry(node.getPos(), node.getRemainingDepth())) {
+			if (canUseEntry) {
+				if (auto entryRes = m_positionTable->get(node.getPos(), node.getRemainingDepth())) {
+					SearchCounters::increment(m_counters->positionTableHits);
 					const auto& entry = *entryRes;
+					if (plyAnalytics) {
+						plyAnalytics->positionTableHits[entry.bound]++;
+					}
 					pvMove = entry.bestMove;
 					
 					if (!wouldMakeRepetition(node.getPos(), entry.bestMove, node.getRepetitionMap()) && entry.depth >= node.getRemainingDepth()) {
@@ -169,18 +334,52 @@ namespace chess {
 				}
 			}
 			if (node.isDone()) {
+				SearchCounters::increment(m_counters->leafNodes);
 				return { Move::null(), node.getRating(), false }; //safe to return Move::null(), as node is never done at the root
 			}
-			return bestChildPosition<Maximizing>(node, pvMove, alphaBeta);
+			return bestChildPosition<Maximizing, Type>(node, pvMove, alphaBeta);
 		}
 
-		template<bool Maximizing>
+		static Node makeChild(const Node& parent, const MovePriority& movePriority) {
+			profiler::ScopedZone zone{ profiler::Zone::NodeConstruction };
+			return Node{ parent, movePriority };
+		}
+
+		//the first move of a PV node continues the principal variation. Every other child is a NonPV node.
+		template<bool Maximizing, NodeType Type>
+		MoveRating searchChild(const Node& child, bool isFirstMove, AlphaBeta alphaBeta) {
+			if constexpr (Type == NodeType::PV) {
+				if (isFirstMove) {
+					return tryShortCircuit<!Maximizing, NodeType::PV>(child, alphaBeta);
+				}
+			}
+			return tryShortCircuit<!Maximizing, NodeType::NonPV>(child, alphaBeta);
+		}
+
+		//rewards the capture that caused a cutoff, and penalizes the captures searched before it that didn't
+		void updateCaptureHistory(const Node& node, const arena::Vector<MovePriority>& movePriorities, size_t cutoffIndex) {
+			auto depth = static_cast<std::int32_t>(node.getRemainingDepth().get());
+			auto bonus = std::min(32 * depth * depth, CaptureHistory::MAX_VALUE / 2);
+
+			const auto& cutoffMove = movePriorities[cutoffIndex].getMove();
+			if (cutoffMove.capturedPiece != Piece::None) {
+				m_captureHistory.update(cutoffMove, bonus);
+			}
+			for (const auto& movePriority : movePriorities | std::views::take(cutoffIndex)) {
+				if (movePriority.getMove().capturedPiece != Piece::None) {
+					m_captureHistory.update(movePriority.getMove(), -bonus);
+				}
+			}
+		}
+
+		template<bool Maximizing, NodeType Type>
 		MoveRating bestChildPosition(const Node& node, const Move& pvMove, AlphaBeta alphaBeta) {
 			auto originalAlphaBeta = alphaBeta;
 
 			auto& killerMoves = m_killerMoves[node.getLevel().get()];
-			auto movePriorities = getMovePriorities(node, pvMove, std::span{ killerMoves.killerMoves.data(), MAX_KILLER_MOVES });;
-			if (m_helper && node.getLevel() < RANDOMIZATION_CUTOFF) {
+			auto movePriorities = getMovePriorities(node, pvMove, std::span{ killerMoves.killerMoves.data(), m_parameters.killerMoves },
+				m_captureHistory, m_parameters);
+			if (m_helper && node.getLevel() < m_parameters.randomizationCutoff) {
 				std::ranges::shuffle(movePriorities, m_urbg);
 			}
 
@@ -189,18 +388,35 @@ namespace chess {
 			auto bound = InWindow;
 			bool didNotPrune = true;
 
-			for (const auto& movePriority : movePriorities) {
-				Node child{ node, movePriority };
-				auto childRating = tryShortCircuit<!Maximizing>(child, alphaBeta);
+			auto plyAnalytics = getPlyAnalytics(node);
+			if (plyAnalytics) {
+				plyAnalytics->expandedNodes++;
+			}
+
+			for (auto&& [moveIndex, movePriority] : std::views::enumerate(movePriorities)) {
+				auto child = makeChild(node, movePriority);
+				auto isFirstMove = moveIndex == 0;
+
+				auto childRating = searchChild<Maximizing, Type>(child, isFirstMove, alphaBeta);
+				if (plyAnalytics) {
+					plyAnalytics->childrenSearched++;
+				}
 
 				//ensure that we don't accidentally pick a move whose depth priority was trimmed by LMR
 				if (movePriority.isTrimmed()) {
+					if (plyAnalytics) {
+						plyAnalytics->reducedMoves++;
+					}
 					auto mayChooseThisMove = Maximizing ? childRating.rating >= alphaBeta.getAlpha() :
 														  childRating.rating <= alphaBeta.getBeta();
 					if (mayChooseThisMove) {
+						SearchCounters::increment(m_counters->lmrResearches);
+						if (plyAnalytics) {
+							plyAnalytics->lmrResearches++;
+						}
 						MovePriority fullMovePriority{ movePriority.getMove(), node.getRemainingDepth() - 1_su8 };
-						Node newChild{ node, fullMovePriority };
-						childRating = tryShortCircuit<!Maximizing>(newChild, alphaBeta);
+						auto newChild = makeChild(node, fullMovePriority);
+						childRating = searchChild<Maximizing, Type>(newChild, isFirstMove, alphaBeta);
 					}
 				}
 
@@ -218,10 +434,21 @@ namespace chess {
 
 				alphaBeta.update<Maximizing>(bestRating.rating);
 				if (alphaBeta.canPrune()) {
+					SearchCounters::increment(m_counters->betaCutoffs);
+					if (moveIndex == 0) {
+						SearchCounters::increment(m_counters->firstMoveCutoffs);
+					}
+					if (plyAnalytics) {
+						plyAnalytics->betaCutoffs++;
+						plyAnalytics->cutoffMoveIndexes[std::min(static_cast<size_t>(moveIndex), PlyAnalytics::CUTOFF_INDEX_BUCKETS - 1)]++;
+					}
+
+					updateCaptureHistory(node, movePriorities, static_cast<size_t>(moveIndex));
+
 					//add killer move
 					if (movePriority.getMove().capturedPiece == Piece::None) {
 						killerMoves.killerMoves[killerMoves.index] = movePriority.getMove();
-						killerMoves.index = killerMoves.index + 1 == MAX_KILLER_MOVES ? 0 : killerMoves.index + 1;
+						killerMoves.index = killerMoves.index + 1 >= m_parameters.killerMoves ? 0 : killerMoves.index + 1;
 					}
 					
 					bound = Maximizing ? LowerBound : UpperBound;
@@ -246,9 +473,12 @@ namespace chess {
 				}
 			}
 
-			if (!bestRating.invalidTTEntry) {
+			if (!bestRating.invalidTTEntry && !isStopped()) { //ratings are meaningless once the search has been cut off
 				PositionEntry newEntry{ bestRating.move, bestRating.rating, node.getRemainingDepth(), bound };
-				storePositionEntry(node.getPos(), newEntry);
+				m_positionTable->store(node.getPos(), newEntry);
+				if (plyAnalytics) {
+					plyAnalytics->positionTableStores[bound]++;
+				}
 			}
 
 			bestRating.invalidTTEntry = false; //don't propagate repetition flag up the tree (stop requests will be rechecked)
@@ -259,25 +489,34 @@ namespace chess {
 		MoveRating startAlphaBetaSearch(const Position& pos, SafeUnsigned<std::uint8_t> depth, RepetitionMap repetitionMap) {
 			AlphaBeta alphaBeta;
 			Node root{ pos, depth, repetitionMap };
-			return tryShortCircuit<Maximizing>(root, alphaBeta);
+			return tryShortCircuit<Maximizing, NodeType::PV>(root, alphaBeta);
 		}
 
 		template<bool Maximizing>
 		MoveRating iterativeDeepening(const Position& pos, const RepetitionMap& repetitionMap) {
 			for (auto iterDepth = 1_su8; iterDepth < depth; ++iterDepth) {
 				arena::resetThread();
-				startAlphaBetaSearch<Maximizing>(pos, iterDepth, repetitionMap);
+				completeIteration(iterDepth, startAlphaBetaSearch<Maximizing>(pos, iterDepth, repetitionMap));
 			}
 			arena::resetThread();
-			return startAlphaBetaSearch<Maximizing>(pos, depth, repetitionMap);
+			return completeIteration(depth, startAlphaBetaSearch<Maximizing>(pos, depth, repetitionMap));
 		}
 	public:
 		MoveRating operator()(const Position& pos, const RepetitionMap& repetitionMap) {
-			if (pos.isWhite()) {
-				return iterativeDeepening<true>(pos, repetitionMap);
-			} else {
-				return iterativeDeepening<false>(pos, repetitionMap);
+			profiler::ScopedZone zone{ profiler::Zone::Search };
+			m_counters->reset();
+			m_enforceLimits = false;
+			m_limitReached = false;
+			m_lastCompletedIteration = std::nullopt;
+
+			auto countHardware = perf::isEnabled();
+			auto countersBefore = countHardware ? perf::readThreadCounters() : perf::CounterValues{};
+
+			auto ret = pos.isWhite() ? iterativeDeepening<true>(pos, repetitionMap) : iterativeDeepening<false>(pos, repetitionMap);
+			if (countHardware) {
+				m_counters->storeHardware(perf::readThreadCounters() - countersBefore);
 			}
+			return ret;
 		}
 	};
 
@@ -285,21 +524,23 @@ namespace chess {
 	constexpr auto MAIN_THREAD_INDEX = 0uz;
 
 	struct AsyncSearchState {
-		BS::thread_pool<> pool{ THREAD_COUNT };
+		SearchThreads threads{ THREAD_COUNT };
 		std::atomic_bool stopRequested = false;
 		std::vector<Searcher> searchers;
+		std::atomic<std::shared_ptr<const OpeningBook>> openingBook;
+		std::vector<std::thread::id> threadIDs; //the threads the searchers run on, whose arena regions are reset for every search
 
 		AsyncSearchState() {
 			searchers.reserve(THREAD_COUNT);
-			searchers.emplace_back(false, &stopRequested); //insert main thread
+			searchers.emplace_back(false, &stopRequested, &getGlobalPositionTable()); //insert main thread
 			if (THREAD_COUNT > 1) {
 				for (auto i = 0uz; i < THREAD_COUNT - 1; i++) { //insert helper threads
-					searchers.emplace_back(true, &stopRequested);
+					searchers.emplace_back(true, &stopRequested, &getGlobalPositionTable());
 				}
 			}
 
 			//register threads (only one of these objects exists for the lifetime of the program, so no duplicate registration)
-			auto threadIDs = pool.get_thread_ids();
+			threadIDs = threads.getThreadIDs();
 			for (auto threadID : threadIDs) {
 				arena::registerThread(threadID);
 			}
@@ -352,7 +593,7 @@ namespace chess {
 
 		for (const auto& [moveRating, searcher] : std::views::zip(moves, searchers)) {
 			if (moveRating.checkmateLevel) {
-				debugPrint(std::format("Thread found checkmate in {} moves", static_cast<std::uint32_t>(moveRating.checkmateLevel->get())));
+				debugPrint("Thread found checkmate in {} moves", static_cast<std::uint32_t>(moveRating.checkmateLevel->get()));
 			}
 			auto& voteRating = moveRatings[moveRating.move];
 			voteRating += searcher.getVotingWeight(moveRating, worstScore, maxScoreDiff);
@@ -366,16 +607,26 @@ namespace chess {
 	} 
 
 	std::optional<Move> findBestMoveImpl(std::shared_ptr<AsyncSearchState> state, Position pos, SafeUnsigned<std::uint8_t> depth, RepetitionMap repetitionMap) {
-		arena::resetAllThreads();
+		if (auto book = state->openingBook.load()) {
+			if (auto bookMove = book->probe(pos)) {
+				for (auto& searcher : state->searchers) { //nothing was searched, so the last search's stats don't describe this move
+					searcher.resetStats();
+				}
+				return bookMove;
+			}
+		}
+
+		arena::resetThreads(state->threadIDs); //an Engine or C API thread in the same program may be using its region right now
 
 		state->assignDepths(depth);
 		state->stopRequested.store(false);
 
-		auto moveCandidateFutures = state->pool.submit_sequence(0uz, state->searchers.size(), [&](size_t i) {
-			return state->searchers[i](pos, repetitionMap);
-		});
-		
-		auto moveCandidates = moveCandidateFutures.get();
+		zAssert(state->threads.size() == state->searchers.size());
+		std::vector<MoveRating> moveCandidates(state->searchers.size());
+		auto searchJob = [&](size_t i) {
+			moveCandidates[i] = state->searchers[i](pos, repetitionMap);
+		};
+		state->threads.run(searchJob);
 		zAssert(!moveCandidates.empty());
 
 		//move candidates could contain null moves if a stop was requested, or if there is checkmate
@@ -397,4 +648,138 @@ namespace chess {
 	void AsyncSearch::cancel() {
 		m_state->stopRequested.store(true);
 	}
+
+	void AsyncSearch::setOpeningBook(std::shared_ptr<const OpeningBook> book) {
+		m_state->openingBook.store(std::move(book));
+	}
+
+	SearchStats AsyncSearch::getStats() const {
+		SearchStats ret;
+		for (const auto& searcher : m_state->searchers) { //the searchers are never added or removed after construction
+			ret += searcher.getStats();
+		}
+		return ret;
+	}
+
+	void AsyncSearch::pinThreads(std::span<const std::uint32_t> processors) {
+		m_state->threads.pin(processors);
+	}
+
+	void AsyncSearch::setParameters(const SearchParameters& parameters) {
+		for (auto& searcher : m_state->searchers) {
+			searcher.setParameters(parameters);
+		}
+	}
+
+	struct IsolatedSearchState {
+		std::atomic_bool stopRequested = false;
+		PositionTable positionTable;
+		Searcher searcher;
+
+		IsolatedSearchState(size_t positionTableSize)
+			: positionTable{ positionTableSize }, searcher{ false, &stopRequested, &positionTable }
+		{
+		}
+	};
+
+	IsolatedSearch::IsolatedSearch(size_t positionTableSize)
+		: m_state{ std::make_shared<IsolatedSearchState>(positionTableSize) }
+	{
+	}
+
+	SearchResult makeSearchResult(const MoveRating& moveRating, SafeUnsigned<std::uint8_t> depth, std::uint64_t nodes, 
+		std::chrono::steady_clock::time_point start)
+	{
+		SearchResult ret;
+		if (moveRating.move != Move::null()) {
+			ret.bestMove = moveRating.move;
+		}
+		ret.rating = moveRating.rating;
+		ret.checkmateLevel = moveRating.checkmateLevel;
+		ret.depth = depth;
+		ret.nodes = nodes;
+		ret.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		return ret;
+	}
+
+	SearchResult IsolatedSearch::search(const Position& pos, const RepetitionMap& repetitionMap, const SearchLimits& limits, IterationCallback onIteration) {
+		auto& searcher = m_state->searcher;
+		auto start = std::chrono::steady_clock::now();
+
+		searcher.setLimits(limits, start);
+		searcher.setIterationCallback([&](SafeUnsigned<std::uint8_t> iterDepth, const MoveRating& moveRating) {
+			if (onIteration) {
+				onIteration(makeSearchResult(moveRating, iterDepth, searcher.getNodeCount(), start));
+			}
+		});
+
+		auto finalRating = searcher(pos, repetitionMap);
+		searcher.setIterationCallback(nullptr); //don't keep references to this stack frame
+		
+		//if we were cut off mid-iteration, fall back on the deepest iteration that finished
+		if (const auto& lastIteration = searcher.getLastCompletedIteration()) {
+			const auto& [completedDepth, completedRating] = *lastIteration;
+			return makeSearchResult(completedRating, completedDepth, searcher.getNodeCount(), start);
+		}
+		return makeSearchResult(finalRating, 0_su8, searcher.getNodeCount(), start);
+	}
+
+	std::vector<Move> IsolatedSearch::getPrincipalVariation(const Position& pos, const SearchResult& result) const {
+		std::vector<Move> ret;
+		if (!result.bestMove) {
+			return ret;
+		}
+		ret.push_back(*result.bestMove);
+
+		auto region = arena::getMemoryRegion();
+		auto maxLength = static_cast<size_t>(result.depth.get());
+		Position curr{ pos, *result.bestMove };
+		std::vector<size_t> visitedHashes{ pos.hash(), curr.hash() };
+		while (ret.size() < maxLength) {
+			auto entry = m_state->positionTable.get(curr, 0_su8);
+			if (!entry || entry->bestMove == Move::null()) {
+				break;
+			}
+
+			//entries are only keyed by hash, so make sure a collision didn't give us a move from another position
+			auto offset = region->getOffset();
+			auto isLegal = false;
+			{
+				auto posData = calcPositionData(curr);
+				isLegal = std::ranges::contains(posData.legalMoves, entry->bestMove);
+			}
+			region->resetToOffset(offset);
+			if (!isLegal) {
+				break;
+			}
+
+			ret.push_back(entry->bestMove);
+			curr = Position{ curr, entry->bestMove };
+			if (std::ranges::contains(visitedHashes, curr.hash())) { //a repetition would loop forever
+				break;
+			}
+			visitedHashes.push_back(curr.hash());
+		}
+		return ret;
+	}
+
+	void IsolatedSearch::setAnalytics(SearchAnalytics* analytics) {
+		m_state->searcher.setAnalytics(analytics);
+	}
+
+	void IsolatedSearch::setParameters(const SearchParameters& parameters) {
+		m_state->searcher.setParameters(parameters);
+	}
+
+	void IsolatedSearch::clearPositionTable() {
+		m_state->positionTable.clear();
+	}
+
+	void IsolatedSearch::cancel() {
+		m_state->stopRequested.store(true);
+	}
+
+	void IsolatedSearch::resetCancel() {
+		m_state->stopRequested.store(false);
+	}
 }
\ No newline at end of file
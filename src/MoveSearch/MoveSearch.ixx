@@ -2,15 +2,64 @@ export module Chess.MoveSearch;
 
 export import std;
 
+import Chess.OpeningBook;
+export import Chess.PerfCounters;
 import Chess.Position;
 import Chess.SafeInt;
 import Chess.Position.RepetitionMap;
 
+export import :MoveSearchBenchmarks;
 export import :MoveSearchTests;
 export import :PositionTable;
+export import :SearchAnalytics;
+export import :SearchParameters;
 
 namespace chess {
+	export constexpr SafeUnsigned<std::uint8_t> MAX_SEARCH_DEPTH{ 29 };
+
+	export struct SearchLimits {
+		SafeUnsigned<std::uint8_t> depth = MAX_SEARCH_DEPTH;
+		std::optional<std::uint64_t> nodes = std::nullopt;
+		std::optional<std::chrono::milliseconds> moveTime = std::nullopt;
+	};
+
+	export struct SearchResult {
+		std::optional<Move> bestMove = std::nullopt; //std::nullopt if there are no legal moves
+		Rating rating = 0_rt; //from white's perspective
+		std::optional<SafeUnsigned<std::uint8_t>> checkmateLevel = std::nullopt;
+		SafeUnsigned<std::uint8_t> depth{ 0 };
+		std::uint64_t nodes = 0;
+		std::chrono::nanoseconds time{ 0 };
+	};
+
+	export struct SearchStats {
+		std::uint64_t nodes = 0;
+		std::uint64_t leafNodes = 0; //nodes evaluated statically at the end of their search depth
+		std::uint64_t positionTableHits = 0;
+		std::uint64_t betaCutoffs = 0;
+		std::uint64_t firstMoveCutoffs = 0; //beta cutoffs caused by the first move searched
+		std::uint64_t lmrResearches = 0; //late move reductions that had to be searched again at full depth
+		std::uint8_t selectiveDepth = 0;
+		perf::CounterValues hardware; //only counted while perf::isEnabled()
+
+		SearchStats& operator+=(const SearchStats& other) {
+			nodes += other.nodes;
+			leafNodes += other.leafNodes;
+			positionTableHits += other.positionTableHits;
+			betaCutoffs += other.betaCutoffs;
+			firstMoveCutoffs += other.firstMoveCutoffs;
+			lmrResearches += other.lmrResearches;
+			selectiveDepth = std::max(selectiveDepth, other.selectiveDepth);
+			hardware += other.hardware;
+			return *this;
+		}
+	};
+
+	//called after every completed iterative deepening iteration
+	export using IterationCallback = std::move_only_function<void(const SearchResult&)>;
+
 	struct AsyncSearchState;
+	struct IsolatedSearchState;
 
 	export class AsyncSearch {
 	private:
@@ -20,5 +69,43 @@ namespace chess {
 
 		std::optional<Move> findBestMove(const Position& pos, SafeUnsigned<std::uint8_t> depth, const RepetitionMap& repetitionMap);
 		void cancel();
+
+		//book moves are played instantly. Pass nullptr to stop using the book.
+		void setOpeningBook(std::shared_ptr<const OpeningBook> book);
+
+		//totals over every search thread for the current or most recent search, all zero if the last move came from the
+		//opening book. Safe to call while searching.
+		SearchStats getStats() const;
+
+		//search thread i is pinned to processors[i % size]. An empty span lets the threads run anywhere.
+		void pinThreads(std::span<const std::uint32_t> processors);
+
+		//applies to every search thread. Must not be called while searching.
+		void setParameters(const SearchParameters& parameters);
+	};
+
+	//single threaded search with its own transposition table. Runs on the calling thread, which must be registered with the arena.
+	export class IsolatedSearch {
+	private:
+		std::shared_ptr<IsolatedSearchState> m_state;
+	public:
+		static constexpr size_t DEFAULT_TABLE_SIZE = DEFAULT_POSITION_TABLE_SIZE;
+
+		explicit IsolatedSearch(size_t positionTableSize = DEFAULT_TABLE_SIZE);
+
+		SearchResult search(const Position& pos, const RepetitionMap& repetitionMap, const SearchLimits& limits, IterationCallback onIteration = nullptr);
+		void clearPositionTable();
+		//stops the running search, or the next one if none is running. Stays in effect until resetCancel is called.
+		void cancel();
+		void resetCancel();
+
+		//result.bestMove followed by the best replies stored in the transposition table, at most result.depth moves long
+		std::vector<Move> getPrincipalVariation(const Position& pos, const SearchResult& result) const;
+
+		//adds the shape of every following search to analytics, until called with nullptr. analytics must outlive the searches.
+		void setAnalytics(SearchAnalytics* analytics);
+
+		//must not be called while searching
+		void setParameters(const SearchParameters& parameters);
 	};
-}
\ No newline at end of file
+}
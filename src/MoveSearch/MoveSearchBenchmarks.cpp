@@ -0,0 +1,101 @@
+module Chess.MoveSearch:MoveSearchBenchmarks;
+
+import Chess.Arena;
+import Chess.MoveGeneration;
+import Chess.Position.RepetitionMap;
+
+import :MoveOrdering;
+import :Node;
+import :PositionTable;
+
+namespace chess {
+	namespace benchmarks {
+		void benchmarkMoveOrdering(MicrobenchmarkRunner& runner, std::span<const Position> corpus) {
+			auto memoryRegion = arena::getMemoryRegion();
+			auto offset = memoryRegion->getOffset();
+			{
+				RepetitionMap repetitionMap;
+				std::list<Node> roots; //nodes can't be moved, so they have to be constructed in place
+				for (const auto& pos : corpus) {
+					roots.emplace_back(pos, 1_su8, repetitionMap);
+				}
+
+				CaptureHistory captureHistory;
+				runner.run("getMovePriorities", [&] {
+					auto searchOffset = memoryRegion->getOffset();
+					for (const auto& root : roots) {
+						auto priorities = getMovePriorities(root, Move::null(), {}, captureHistory, SearchParameters{});
+						doNotOptimize(priorities.data());
+					}
+					memoryRegion->resetToOffset(searchOffset);
+				});
+			}
+			memoryRegion->resetToOffset(offset);
+		}
+
+		//random games from the corpus positions, with a fixed seed so that every run probes the same keys
+		std::vector<Position> playOutPositions(std::span<const Position> corpus, size_t count) {
+			constexpr auto MAX_GAME_LENGTH = 64uz;
+
+			auto memoryRegion = arena::getMemoryRegion();
+			std::mt19937 urbg{ 0 };
+			std::vector<Position> ret;
+			ret.reserve(count);
+			for (auto i = 0uz; ret.size() < count; i++) {
+				auto pos = corpus[i % corpus.size()];
+				for (auto ply = 0uz; ply < MAX_GAME_LENGTH && ret.size() < count; ply++) {
+					auto offset = memoryRegion->getOffset();
+					std::optional<Move> move;
+					{
+						auto posData = calcPositionData(pos);
+						if (!posData.legalMoves.empty()) {
+							move = posData.legalMoves[std::uniform_int_distribution<size_t>{ 0, posData.legalMoves.size() - 1 }(urbg)];
+						}
+					}
+					memoryRegion->resetToOffset(offset);
+					if (!move) { //checkmate or stalemate, start the next game
+						break;
+					}
+
+					pos = Position{ pos, *move };
+					ret.push_back(pos);
+				}
+			}
+			return ret;
+		}
+
+		void runPositionTableBenchmarks(std::span<const Position> corpus) {
+			auto positions = playOutPositions(corpus, DEFAULT_POSITION_TABLE_SIZE);
+			PositionTable table{ DEFAULT_POSITION_TABLE_SIZE };
+			PositionEntry entry;
+			entry.depth = 1_su8;
+			for (const auto& pos : positions) {
+				table.store(pos, entry);
+			}
+
+			//the positions are stored in play order, but their hashes scatter the probes across the whole table
+			std::println("Measuring a {} entry position table...", DEFAULT_POSITION_TABLE_SIZE);
+			MicrobenchmarkRunner runner{ positions.size() };
+			runner.run("PositionTable::get", [&] {
+				auto hits = 0uz;
+				for (const auto& pos : positions) {
+					if (table.get(pos, 0_su8)) {
+						hits++;
+					}
+				}
+				doNotOptimize(&hits);
+			});
+			//the table is full, so this is the cost of updating the entries of known positions, as in a long search
+			runner.run("PositionTable::store", [&] {
+				for (const auto& pos : positions) {
+					table.store(pos, entry);
+				}
+			});
+			runner.printResults();
+		}
+
+		void runInternalMoveSearchBenchmarks(MicrobenchmarkRunner& runner, std::span<const Position> corpus) {
+			benchmarkMoveOrdering(runner, corpus);
+		}
+	}
+}
@@ -0,0 +1,16 @@
+export module Chess.MoveSearch:MoveSearchBenchmarks;
+
+export import std;
+export import Chess.Benchmark;
+export import Chess.Position;
+
+export namespace chess {
+	namespace benchmarks {
+		//the calling thread must be registered with the arena
+		void runInternalMoveSearchBenchmarks(MicrobenchmarkRunner& runner, std::span<const Position> corpus);
+
+		//probes a default sized table filled with positions played out from the corpus, so that most probes miss the cache.
+		//Prints its own results, since every call covers the whole table rather than one pass over the corpus.
+		void runPositionTableBenchmarks(std::span<const Position> corpus);
+	}
+}
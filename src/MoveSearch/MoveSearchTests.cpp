@@ -1,5 +1,6 @@
 module Chess.MoveSearch:MoveSearchTests;
 
+import Chess.Arena;
 import Chess.Position;
 import Chess.PositionCommand;
 import :MoveOrdering;
@@ -14,17 +15,35 @@ namespace chess {
 		}
 
 		void testMoveOrdering() {
-			//Position pos;
-			//pos.setPos(parsePositionCommand("fen rnbq1k1r/3p1ppp/1p1b1n1Q/pBp1p3/4P2P/N2P3R/PPP2PP1/R1B1K1N1 b Q - 2 8"));
-			//RepetitionMap rMap;
+			Position pos;
+			pos.setPos(parsePositionCommand("fen rnbq1k1r/3p1ppp/1p1b1n1Q/pBp1p3/4P2P/N2P3R/PPP2PP1/R1B1K1N1 b Q - 2 8"));
+			RepetitionMap rMap;
+			{
+				Node node{ pos, 2_su8, rMap };
+				CaptureHistory captureHistory;
+				auto priorities = getMovePriorities(node, Move::null(), {}, captureHistory, SearchParameters{});
 
-			//auto node = Node::makeRoot(pos, 1_su8, rMap);
-			//auto priorities = getMovePriorities(node, Move::null());
+				if (priorities[0].getMove().to != Square::H6) {
+					std::println("testMoveOrdering failed: queen capture is not the best move");
+					printPriorities(priorities);
+				}
+			}
+			arena::resetThread();
+		}
 
-			//if (priorities[0].getMove().to != Square::H6) {
-			//	std::println("testMoveOrdering failed: queen capture is not the best move");
-			//	printPriorities(priorities);
-			//}
+		void testCaptureHistory() {
+			CaptureHistory captureHistory;
+			constexpr Move CAPTURE{ Square::G7, Square::H6, Square::None, Pawn, Queen, Piece::None };
+			for (auto i = 0; i < 100; i++) {
+				captureHistory.update(CAPTURE, CaptureHistory::MAX_VALUE);
+			}
+			if (captureHistory.get(CAPTURE) != CaptureHistory::MAX_VALUE) {
+				std::println("testCaptureHistory failed: {} is not saturated at {}", captureHistory.get(CAPTURE), CaptureHistory::MAX_VALUE);
+			}
+			captureHistory.update(CAPTURE, -CaptureHistory::MAX_VALUE / 2);
+			if (captureHistory.get(CAPTURE) >= CaptureHistory::MAX_VALUE) {
+				std::println("testCaptureHistory failed: a penalty did not lower the entry");
+			}
 		}
 
 		void testMoveOrdering2() {
@@ -42,6 +61,7 @@ namespace chess {
 		void runInternalMoveSearchTests() {
 			testMoveOrdering();
 			testMoveOrdering2();
+			testCaptureHistory();
 		}
 	}
 }
\ No newline at end of file
@@ -1,21 +1,24 @@
 module;
 
-//#include <boost/unordered/unordered_flat_map.hpp>
-//#include <boost/unordered/unordered_node_map.hpp>
 #include <boost/unordered/concurrent_flat_map.hpp>
 
 module Chess.MoveSearch:PositionTable;
 
+import Chess.Profiler;
+
 import :MoveHasher;
 
 namespace chess {
-	using PositionMap = boost::concurrent_flat_map<std::uint64_t, PositionEntry>;
-
-	PositionMap positionMap;
+	PositionTable::PositionTable(size_t maxEntryCount)
+		: m_maxEntryCount{ maxEntryCount }
+	{
+		m_entries.reserve(maxEntryCount);
+	}
 
-	std::optional<PositionEntry> getPositionEntry(const Position& pos, SafeUnsigned<std::uint8_t> depth) {
+	std::optional<PositionEntry> PositionTable::get(const Position& pos, SafeUnsigned<std::uint8_t> depth) const {
+		profiler::ScopedZone zone{ profiler::Zone::PositionTableProbe };
 		PositionEntry ret;
-		auto found = positionMap.visit(pos.hash(), [&](const auto& kv) {
+		auto found = m_entries.visit(pos.hash(), [&](const auto& kv) {
 			ret = kv.second;
 		});
 		if (!found || ret.depth < depth) {
@@ -24,15 +27,30 @@ namespace chess {
 		return ret;
 	}
 
-	void storePositionEntry(const Position& pos, const PositionEntry& entry) {
-		positionMap.emplace_or_visit(pos.hash(), entry, [&](auto& storedKV) {
+	void PositionTable::store(const Position& pos, const PositionEntry& entry) {
+		profiler::ScopedZone zone{ profiler::Zone::PositionTableStore };
+		auto replace = [&](auto& storedKV) {
 			if (entry.depth >= storedKV.second.depth) {
 				storedKV.second = entry;
 			} //sometimes we get shallower depths when we start a new game, ignore these
-		});
+		};
+		if (m_entries.size() >= m_maxEntryCount) { //table is full, so only update positions we already know about
+			m_entries.visit(pos.hash(), replace);
+			return;
+		}
+		m_entries.emplace_or_visit(pos.hash(), entry, replace);
+	}
+
+	void PositionTable::clear() {
+		m_entries.clear();
+	}
+
+	PositionTable& getGlobalPositionTable() {
+		static PositionTable table;
+		return table;
 	}
 
 	void clearTranspositionTable() {
-		positionMap.clear();
+		getGlobalPositionTable().clear();
 	}
-}
\ No newline at end of file
+}
@@ -1,3 +1,7 @@
+module;
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+
 export module Chess.MoveSearch:PositionTable;
 
 export import std;
@@ -22,8 +26,23 @@ namespace chess {
 	};
 	using PositionEntryRef = std::reference_wrapper<const PositionEntry>;
 
-	std::optional<PositionEntry> getPositionEntry(const Position& pos, SafeUnsigned<std::uint8_t> depth);
-	void storePositionEntry(const Position& pos, const PositionEntry& entry);
+	constexpr size_t DEFAULT_POSITION_TABLE_SIZE = 1uz << 20;
+
+	class PositionTable {
+	private:
+		boost::concurrent_flat_map<std::uint64_t, PositionEntry> m_entries;
+		size_t m_maxEntryCount = std::numeric_limits<size_t>::max();
+	public:
+		PositionTable() = default;
+		explicit PositionTable(size_t maxEntryCount);
+
+		std::optional<PositionEntry> get(const Position& pos, SafeUnsigned<std::uint8_t> depth) const;
+		void store(const Position& pos, const PositionEntry& entry);
+		void clear();
+	};
+
+	//the table shared by every AsyncSearch
+	PositionTable& getGlobalPositionTable();
 
 	export void clearTranspositionTable();
-}
\ No newline at end of file
+}
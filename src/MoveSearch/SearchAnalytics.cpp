@@ -0,0 +1,58 @@
+module Chess.MoveSearch:SearchAnalytics;
+
+import nlohmann.json;
+
+namespace chess {
+	double calcRate(std::uint64_t count, std::uint64_t total) {
+		return total == 0 ? 0.0 : static_cast<double>(count) / static_cast<double>(total);
+	}
+
+	nlohmann::json boundsToJSON(const std::array<std::uint64_t, PlyAnalytics::BOUND_COUNT>& counts) {
+		nlohmann::json ret;
+		ret["exact"] = counts[0];
+		ret["lower"] = counts[1];
+		ret["upper"] = counts[2];
+		return ret;
+	}
+
+	void writeSearchAnalytics(const SearchAnalytics& analytics, const std::filesystem::path& path) {
+		nlohmann::json output;
+		output["plies"] = nlohmann::json::array();
+
+		//plies deeper than the search reached are left out
+		auto reachedPlies = analytics.plies | std::views::take_while([](const PlyAnalytics& plyAnalytics) {
+			return plyAnalytics.nodes > 0;
+		}) | std::ranges::to<std::vector>();
+
+		for (const auto& [ply, plyAnalytics] : std::views::enumerate(reachedPlies)) {
+			auto nextPly = static_cast<size_t>(ply) + 1;
+			auto nextPlyNodes = nextPly < reachedPlies.size() ? reachedPlies[nextPly].nodes : 0;
+
+			auto weightedIndexSum = 0.0;
+			for (const auto& [index, count] : std::views::enumerate(plyAnalytics.cutoffMoveIndexes)) {
+				weightedIndexSum += static_cast<double>(index) * static_cast<double>(count);
+			}
+
+			nlohmann::json plyJSON;
+			plyJSON["ply"] = ply;
+			plyJSON["nodes"] = plyAnalytics.nodes;
+			plyJSON["expanded_nodes"] = plyAnalytics.expandedNodes;
+			plyJSON["effective_branching_factor"] = calcRate(nextPlyNodes, plyAnalytics.nodes);
+			plyJSON["children_per_expanded_node"] = calcRate(plyAnalytics.childrenSearched, plyAnalytics.expandedNodes);
+			plyJSON["beta_cutoffs"] = plyAnalytics.betaCutoffs;
+			plyJSON["cutoff_rate"] = calcRate(plyAnalytics.betaCutoffs, plyAnalytics.expandedNodes);
+			plyJSON["first_move_cutoff_rate"] = calcRate(plyAnalytics.cutoffMoveIndexes[0], plyAnalytics.betaCutoffs);
+			plyJSON["mean_cutoff_move_index"] = plyAnalytics.betaCutoffs == 0 ? 0.0 : weightedIndexSum / static_cast<double>(plyAnalytics.betaCutoffs);
+			plyJSON["cutoff_move_indexes"] = plyAnalytics.cutoffMoveIndexes;
+			plyJSON["reduced_moves"] = plyAnalytics.reducedMoves;
+			plyJSON["lmr_researches"] = plyAnalytics.lmrResearches;
+			plyJSON["lmr_research_rate"] = calcRate(plyAnalytics.lmrResearches, plyAnalytics.reducedMoves);
+			plyJSON["position_table_hits"] = boundsToJSON(plyAnalytics.positionTableHits);
+			plyJSON["position_table_stores"] = boundsToJSON(plyAnalytics.positionTableStores);
+			output["plies"].push_back(plyJSON);
+		}
+
+		std::ofstream file{ path };
+		file << output.dump(2);
+	}
+}
@@ -0,0 +1,28 @@
+export module Chess.MoveSearch:SearchAnalytics;
+
+export import std;
+
+export namespace chess {
+	struct PlyAnalytics {
+		static constexpr size_t CUTOFF_INDEX_BUCKETS = 16; //the last bucket counts every later cutoff
+		static constexpr size_t BOUND_COUNT = 3; //exact, lower, upper
+
+		std::uint64_t nodes = 0;
+		std::uint64_t expandedNodes = 0; //nodes whose children were searched
+		std::uint64_t childrenSearched = 0;
+		std::uint64_t betaCutoffs = 0;
+		std::array<std::uint64_t, CUTOFF_INDEX_BUCKETS> cutoffMoveIndexes{}; //how far down the ordered move list each cutoff happened
+		std::uint64_t reducedMoves = 0; //moves searched with an LMR trimmed depth
+		std::uint64_t lmrResearches = 0;
+		std::array<std::uint64_t, BOUND_COUNT> positionTableHits{}; //by the bound of the entry found
+		std::array<std::uint64_t, BOUND_COUNT> positionTableStores{}; //by the bound of the entry stored
+	};
+
+	//search tree shape, indexed by ply. Collected by IsolatedSearch when enabled, summed over every search and iteration.
+	struct SearchAnalytics {
+		std::vector<PlyAnalytics> plies;
+	};
+
+	//writes per ply branching factors, cutoff and LMR rates and table bound distributions for the profiling visualizer
+	void writeSearchAnalytics(const SearchAnalytics& analytics, const std::filesystem::path& path);
+}
@@ -0,0 +1,64 @@
+export module Chess.MoveSearch:SearchParameters;
+
+export import std;
+
+export import Chess.SafeInt;
+
+export namespace chess {
+	//search constants that are read at runtime, so that they can be tuned without recompiling
+	struct SearchParameters {
+		static constexpr size_t MAX_KILLER_MOVES = 3; //killer move slots that are allocated per ply
+
+		double lmrBase = 0.99;    //late move reductions are lmrBase + log2(depth) * log2(moveIndex) / lmrDivisor plies
+		double lmrDivisor = 3.14;
+		SafeUnsigned<std::uint8_t> randomizationCutoff{ 3 }; //AsyncSearch helper threads shuffle their moves above this ply
+		size_t killerMoves = MAX_KILLER_MOVES; //killer moves remembered per ply, in [1, MAX_KILLER_MOVES]
+	};
+
+	//a SearchParameters field as a real number, so that the tuner can treat every parameter the same way
+	struct TunableParameter {
+		std::string_view name;
+		double min = 0.0;
+		double max = 0.0;
+		double step = 0.0; //how far the tuner perturbs this parameter by the end of a run
+		double spinScale = 1.0; //UCI spin options are integers, so they hold the value times spinScale
+		double (*get)(const SearchParameters&) = nullptr;
+		void (*set)(SearchParameters&, double) = nullptr; //rounds integer parameters
+
+		void apply(SearchParameters& parameters, double value) const {
+			set(parameters, std::clamp(value, min, max));
+		}
+
+		std::int64_t toSpin(double value) const {
+			return std::llround(value * spinScale);
+		}
+		double fromSpin(std::int64_t spin) const {
+			return static_cast<double>(spin) / spinScale;
+		}
+	};
+
+	//randomizationCutoff is left out, because IsolatedSearch has no helper threads for self-play to measure it with
+	std::span<const TunableParameter> getTunableParameters() {
+		static constexpr std::array<TunableParameter, 3> PARAMETERS{ {
+			{ "lmr_base", 0.0, 2.0, 0.1, 100.0,
+				[](const SearchParameters& p) { return p.lmrBase; },
+				[](SearchParameters& p, double value) { p.lmrBase = value; } },
+			{ "lmr_divisor", 1.0, 6.0, 0.25, 100.0,
+				[](const SearchParameters& p) { return p.lmrDivisor; },
+				[](SearchParameters& p, double value) { p.lmrDivisor = value; } },
+			{ "killer_moves", 1.0, static_cast<double>(SearchParameters::MAX_KILLER_MOVES), 1.0, 1.0,
+				[](const SearchParameters& p) { return static_cast<double>(p.killerMoves); },
+				[](SearchParameters& p, double value) { p.killerMoves = static_cast<size_t>(std::round(value)); } },
+		} };
+		return PARAMETERS;
+	}
+
+	std::optional<TunableParameter> findTunableParameter(std::string_view name) {
+		auto parameters = getTunableParameters();
+		auto it = std::ranges::find(parameters, name, &TunableParameter::name);
+		if (it == parameters.end()) {
+			return std::nullopt;
+		}
+		return *it;
+	}
+}
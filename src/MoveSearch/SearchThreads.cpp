@@ -0,0 +1,63 @@
+module Chess.MoveSearch:SearchThreads;
+
+import Chess.ThreadAffinity;
+
+namespace chess {
+	SearchThreads::SearchThreads(size_t threadCount) {
+		m_threads.reserve(threadCount);
+		for (auto i = 0uz; i < threadCount; i++) {
+			m_threads.emplace_back([this, i] {
+				threadLoop(i);
+			});
+		}
+	}
+
+	SearchThreads::~SearchThreads() {
+		m_exiting.store(true);
+		m_generation.fetch_add(1, std::memory_order_release);
+		m_generation.notify_all();
+	}
+
+	std::vector<std::thread::id> SearchThreads::getThreadIDs() const {
+		return m_threads | std::views::transform([](const std::jthread& thread) {
+			return thread.get_id();
+		}) | std::ranges::to<std::vector>();
+	}
+
+	void SearchThreads::pin(std::span<const std::uint32_t> processors) {
+		for (auto&& [i, thread] : std::views::enumerate(m_threads)) {
+			if (processors.empty()) {
+				pinThread(thread, {});
+			} else {
+				pinThread(thread, processors.subspan(static_cast<size_t>(i) % processors.size(), 1));
+			}
+		}
+	}
+
+	void SearchThreads::threadLoop(size_t threadIndex) {
+		std::uint64_t seenGeneration = 0;
+		while (true) {
+			m_generation.wait(seenGeneration, std::memory_order_acquire);
+			seenGeneration = m_generation.load(std::memory_order_acquire);
+			if (m_exiting.load()) {
+				return;
+			}
+
+			m_invokeJob(m_job, threadIndex);
+
+			if (m_runningCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				m_runningCount.notify_one();
+			}
+		}
+	}
+
+	void SearchThreads::runImpl() {
+		m_runningCount.store(m_threads.size(), std::memory_order_relaxed);
+		m_generation.fetch_add(1, std::memory_order_release); //publishes the job to the threads
+		m_generation.notify_all();
+
+		for (auto running = m_runningCount.load(std::memory_order_acquire); running != 0; running = m_runningCount.load(std::memory_order_acquire)) {
+			m_runningCount.wait(running, std::memory_order_acquire);
+		}
+	}
+}
@@ -0,0 +1,45 @@
+export module Chess.MoveSearch:SearchThreads;
+
+import std;
+
+namespace chess {
+	//dedicated threads that stay parked on an atomic between searches. Bumping the generation counter wakes them all,
+	//and the last thread to finish wakes the caller, so starting a search doesn't go through a task queue or futures.
+	class SearchThreads {
+	private:
+		using InvokeJob = void(*)(void* job, size_t threadIndex);
+
+		std::atomic<std::uint64_t> m_generation = 0;
+		std::atomic<size_t> m_runningCount = 0;
+		std::atomic_bool m_exiting = false;
+		void* m_job = nullptr;
+		InvokeJob m_invokeJob = nullptr;
+		std::vector<std::jthread> m_threads; //declared last, so the threads are joined before anything they use is destroyed
+
+		void threadLoop(size_t threadIndex);
+		void runImpl();
+	public:
+		explicit SearchThreads(size_t threadCount);
+		SearchThreads(const SearchThreads&) = delete;
+		SearchThreads& operator=(const SearchThreads&) = delete;
+		~SearchThreads();
+
+		size_t size() const {
+			return m_threads.size();
+		}
+		std::vector<std::thread::id> getThreadIDs() const;
+
+		//thread i is pinned to processors[i % size]. An empty span lets the threads run anywhere.
+		void pin(std::span<const std::uint32_t> processors);
+
+		//calls job(i) on the ith thread, for every thread, and blocks until all calls have returned
+		template<typename Job>
+		void run(Job& job) {
+			m_job = &job;
+			m_invokeJob = [](void* job, size_t threadIndex) {
+				(*static_cast<Job*>(job))(threadIndex);
+			};
+			runImpl();
+		}
+	};
+}
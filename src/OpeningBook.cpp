@@ -0,0 +1,130 @@
+module Chess.OpeningBook;
+
+import Chess.Arena;
+import Chess.EasyRandom;
+import Chess.MoveGeneration;
+
+namespace chess {
+	OpeningBook::OpeningBook(MemoryMappedFile file)
+		: m_file{ std::move(file) }
+	{
+	}
+
+	std::expected<OpeningBook, std::string> OpeningBook::load(const std::filesystem::path& path) {
+		auto file = MemoryMappedFile::tryOpen(path);
+		if (!file) {
+			return std::unexpected{ std::move(file.error()) };
+		}
+		return OpeningBook{ std::move(*file) };
+	}
+
+	size_t OpeningBook::getEntryCount() const {
+		return m_file.getBytes().size() / ENTRY_SIZE;
+	}
+
+	//entries are stored big endian as { key: 8 bytes, move: 2 bytes, weight: 2 bytes, learn: 4 bytes }
+	template<std::unsigned_integral T>
+	T readBigEndian(std::span<const std::byte> bytes) {
+		T ret = 0;
+		for (auto byte : bytes.first(sizeof(T))) {
+			ret = static_cast<T>((ret << 8) | static_cast<T>(byte));
+		}
+		return ret;
+	}
+
+	OpeningBook::Entry OpeningBook::getEntry(size_t index) const {
+		auto bytes = m_file.getBytes().subspan(index * ENTRY_SIZE, ENTRY_SIZE);
+		return { readBigEndian<std::uint64_t>(bytes), readBigEndian<std::uint16_t>(bytes.subspan(8)), readBigEndian<std::uint16_t>(bytes.subspan(10)) };
+	}
+
+	std::optional<Move> OpeningBook::decodeMove(const Position& pos, std::uint16_t bookMove) const {
+		auto toSquare = [](int file, int rank) {
+			return static_cast<Square>(rank * 8 + file);
+		};
+		auto to = toSquare(bookMove & 7, (bookMove >> 3) & 7);
+		auto from = toSquare((bookMove >> 6) & 7, (bookMove >> 9) & 7);
+		constexpr std::array PROMOTION_PIECES{ Piece::None, Knight, Bishop, Rook, Queen };
+		auto promotionIndex = static_cast<size_t>((bookMove >> 12) & 7);
+		if (promotionIndex >= PROMOTION_PIECES.size()) {
+			return std::nullopt;
+		}
+
+		auto turnData = pos.getTurnData();
+		Move ret{ from, to, turnData.allies.findPiece(from), turnData.enemies.findPiece(to), PROMOTION_PIECES[promotionIndex] };
+		if (ret.movedPiece == Piece::None) { //key collision or corrupt book
+			return std::nullopt;
+		}
+
+		//Polyglot encodes castling as the king capturing its own rook
+		if (ret.movedPiece == King && containsSquare(turnData.allies[Rook], to)) {
+			ret.to = fileOf(to) > fileOf(from) ? turnData.allyKingside.kingTo : turnData.allyQueenside.kingTo;
+			ret.capturedPiece = Piece::None;
+		}
+
+		//a pawn moving diagonally onto an empty square is capturing en passant
+		if (ret.movedPiece == Pawn && ret.capturedPiece == Piece::None && fileOf(from) != fileOf(to)) {
+			ret.capturedPiece = Pawn;
+			ret.capturedPawnSquareEnPassant = turnData.enemies.doubleJumpedPawn;
+		}
+		return ret;
+	}
+
+	//a key collision or a corrupt entry can decode to any move, so only moves that are actually legal are played
+	bool isLegalMove(const Position& pos, const Move& move) {
+		auto region = arena::getMemoryRegion();
+		auto offset = region->getOffset();
+		auto ret = false;
+		{
+			auto posData = calcPositionData(pos);
+			ret = std::ranges::contains(posData.legalMoves, move);
+		}
+		region->resetToOffset(offset);
+		return ret;
+	}
+
+	std::optional<Move> OpeningBook::probe(const Position& pos) const {
+		auto key = pos.polyglotHash();
+
+		//entries are sorted by key
+		auto entryIndices = std::views::iota(0uz, getEntryCount());
+		auto firstIt = std::ranges::lower_bound(entryIndices, key, std::less{}, [this](size_t i) {
+			return getEntry(i).key;
+		});
+		if (firstIt == entryIndices.end()) {
+			return std::nullopt;
+		}
+
+		std::vector<Entry> entries;
+		for (auto i = *firstIt; i < getEntryCount(); i++) {
+			auto entry = getEntry(i);
+			if (entry.key != key) {
+				break;
+			}
+			entries.push_back(entry);
+		}
+		if (entries.empty()) {
+			return std::nullopt;
+		}
+
+		auto totalWeight = std::ranges::fold_left(entries, 0, [](int acc, const Entry& entry) {
+			return acc + entry.weight;
+		});
+		auto chosen = entries.front();
+		if (totalWeight != 0) {
+			auto choice = makeRandomNum(0, totalWeight - 1);
+			for (const auto& entry : entries) {
+				choice -= entry.weight;
+				if (choice < 0) {
+					chosen = entry;
+					break;
+				}
+			}
+		}
+
+		auto move = decodeMove(pos, chosen.move);
+		if (!move || !isLegalMove(pos, *move)) {
+			return std::nullopt;
+		}
+		return move;
+	}
+}
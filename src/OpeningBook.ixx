@@ -0,0 +1,35 @@
+export module Chess.OpeningBook;
+
+import std;
+
+export import Chess.Move;
+export import Chess.Position;
+
+import Chess.MemoryMappedFile;
+
+export namespace chess {
+	//Polyglot (.bin) opening book
+	class OpeningBook {
+	private:
+		MemoryMappedFile m_file;
+
+		struct Entry {
+			std::uint64_t key = 0;
+			std::uint16_t move = 0;
+			std::uint16_t weight = 0;
+		};
+		static constexpr size_t ENTRY_SIZE = 16;
+
+		size_t getEntryCount() const;
+		Entry getEntry(size_t index) const;
+		std::optional<Move> decodeMove(const Position& pos, std::uint16_t bookMove) const;
+
+		explicit OpeningBook(MemoryMappedFile file);
+	public:
+		//returns the error message if the book can't be read, so that a bad path doesn't end the engine
+		static std::expected<OpeningBook, std::string> load(const std::filesystem::path& path);
+
+		//picks one of the book moves at random, weighted by how often it was played
+		std::optional<Move> probe(const Position& pos) const;
+	};
+}
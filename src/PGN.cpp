@@ -0,0 +1,285 @@
+module Chess.PGN;
+
+import BS.thread_pool;
+
+import Chess.Arena;
+import Chess.MemoryMappedFile;
+import Chess.MoveGeneration;
+import Chess.PositionCommand;
+import Chess.SAN;
+
+namespace chess {
+	class PGNTokenizer {
+	private:
+		std::string_view m_text;
+		size_t m_index = 0;
+
+		static bool isSpace(char c) {
+			return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+		}
+
+		void skipUntil(char c) {
+			auto end = m_text.find(c, m_index);
+			m_index = (end == std::string_view::npos) ? m_text.size() : end + 1;
+		}
+
+		void skipVariation() {
+			int nesting = 0;
+			while (m_index < m_text.size()) {
+				auto c = m_text[m_index++];
+				if (c == '(') {
+					nesting++;
+				} else if (c == ')') {
+					if (--nesting == 0) {
+						return;
+					}
+				} else if (c == '{') {
+					skipUntil('}');
+				}
+			}
+		}
+	public:
+		enum class TokenType {
+			Tag,
+			Move,
+			Result,
+			End
+		};
+		struct Token {
+			TokenType type = TokenType::End;
+			std::string_view text;
+		};
+
+		explicit PGNTokenizer(std::string_view text) : m_text{ text } {}
+
+		Token next() {
+			while (m_index < m_text.size()) {
+				auto c = m_text[m_index];
+				if (isSpace(c)) {
+					m_index++;
+				} else if (c == '{') {
+					skipUntil('}');
+				} else if (c == ';' || c == '%') { //rest of line comments and escaped lines
+					skipUntil('\n');
+				} else if (c == '(') {
+					skipVariation();
+				} else if (c == '[') {
+					auto begin = m_index + 1;
+					skipUntil(']');
+					return { TokenType::Tag, m_text.substr(begin, m_index - begin - 1) };
+				} else {
+					auto begin = m_index;
+					while (m_index < m_text.size() && !isSpace(m_text[m_index]) && m_text[m_index] != '{' && 
+						   m_text[m_index] != '(' && m_text[m_index] != ';') 
+					{
+						m_index++;
+					}
+					auto word = m_text.substr(begin, m_index - begin);
+
+					if (word == "1-0" || word == "0-1" || word == "1/2-1/2" || word == "*") {
+						return { TokenType::Result, word };
+					}
+					if (word.front() == '$') { //numeric annotation glyph
+						continue;
+					}
+
+					//strip move numbers ("12." and "12...") which may be glued to the move
+					if (auto lastDot = word.rfind('.'); lastDot != std::string_view::npos) {
+						word.remove_prefix(lastDot + 1);
+					}
+					if (word.empty()) {
+						continue;
+					}
+					return { TokenType::Move, word };
+				}
+			}
+			return { TokenType::End, {} };
+		}
+	};
+
+	PGNResult parseResult(std::string_view resultStr) {
+		if (resultStr == "1-0") {
+			return PGNResult::WhiteWins;
+		} else if (resultStr == "0-1") {
+			return PGNResult::BlackWins;
+		} else if (resultStr == "1/2-1/2") {
+			return PGNResult::Draw;
+		}
+		return PGNResult::Unknown;
+	}
+
+	struct Tag {
+		std::string_view name;
+		std::string_view value;
+	};
+
+	Tag parseTag(std::string_view tagText) {
+		auto nameEnd = tagText.find(' ');
+		if (nameEnd == std::string_view::npos) {
+			return { tagText, {} };
+		}
+		auto valueBegin = tagText.find('"', nameEnd);
+		auto valueEnd = tagText.rfind('"');
+		if (valueBegin == std::string_view::npos || valueEnd <= valueBegin) {
+			return { tagText.substr(0, nameEnd), {} };
+		}
+		return { tagText.substr(0, nameEnd), tagText.substr(valueBegin + 1, valueEnd - valueBegin - 1) };
+	}
+
+	const Position& getStartingPosition() {
+		static const auto startPos = [] {
+			Position ret;
+			ret.setPos(parsePositionCommand("startpos"));
+			return ret;
+		}();
+		return startPos;
+	}
+
+	std::optional<Move> resolveMove(const Position& pos, std::string_view san) {
+		//legal moves are only needed until the move is resolved, so hand the memory straight back to the arena
+		auto region = arena::getMemoryRegion();
+		auto offset = region->getOffset();
+		std::optional<Move> ret;
+		{
+			auto posData = calcPositionData(pos);
+			ret = parseSANMove(san, posData.legalMoves);
+		}
+		region->resetToOffset(offset);
+		return ret;
+	}
+
+	std::generator<const PGNPosition&> readPGNPositions(std::string_view text, PGNStats& stats) {
+		PGNTokenizer tokenizer{ text };
+
+		PGNPosition curr{ getStartingPosition(), PGNResult::Unknown, 0 };
+		bool inGame = false;     //whether the initial position has been reached
+		bool unreadable = false; //skip the rest of the game after an unresolvable move
+
+		//without a Result tag the result is only known at the termination marker, so the game's positions wait here until then
+		std::vector<PGNPosition> pending;
+
+		auto resetGame = [&] {
+			curr = PGNPosition{ getStartingPosition(), PGNResult::Unknown, 0 };
+			inGame = false;
+			unreadable = false;
+			pending.clear();
+		};
+
+		while (true) {
+			auto token = tokenizer.next();
+			if (token.type == PGNTokenizer::TokenType::End) {
+				if (inGame) { //the last game was missing its termination marker, so its result stays unknown
+					stats.gameCount++;
+					for (const auto& pgnPosition : pending) {
+						co_yield pgnPosition;
+					}
+				}
+				co_return;
+			}
+
+			if (token.type == PGNTokenizer::TokenType::Tag) {
+				if (inGame) { //previous game was missing its termination marker
+					stats.gameCount++;
+					for (const auto& pgnPosition : pending) {
+						co_yield pgnPosition;
+					}
+					resetGame();
+				}
+				auto [name, value] = parseTag(token.text);
+				if (name == "Result") {
+					curr.result = parseResult(value);
+				} else if (name == "FEN" && !unreadable && !curr.pos.setFEN(value)) {
+					unreadable = true;
+					stats.unreadableGameCount++;
+				}
+			} else if (token.type == PGNTokenizer::TokenType::Move) {
+				if (!inGame) {
+					inGame = true;
+					if (!unreadable) { //a bad FEN tag leaves nothing to yield
+						stats.positionCount++;
+						if (curr.result == PGNResult::Unknown) {
+							pending.push_back(curr);
+						} else {
+							co_yield curr;
+						}
+					}
+				}
+				if (unreadable) {
+					continue;
+				}
+				auto move = resolveMove(curr.pos, token.text);
+				if (!move) {
+					unreadable = true;
+					stats.unreadableGameCount++;
+					continue;
+				}
+				curr.pos.move(*move);
+				curr.ply++;
+				stats.positionCount++;
+				if (curr.result == PGNResult::Unknown) {
+					pending.push_back(curr);
+				} else {
+					co_yield curr;
+				}
+			} else if (token.type == PGNTokenizer::TokenType::Result) {
+				if (curr.result == PGNResult::Unknown) {
+					curr.result = parseResult(token.text);
+				}
+				for (auto& pgnPosition : pending) {
+					pgnPosition.result = curr.result;
+					co_yield pgnPosition;
+				}
+				if (!inGame) { //game without moves
+					stats.positionCount++;
+					co_yield curr;
+				}
+				stats.gameCount++;
+				resetGame();
+			}
+		}
+	}
+
+	//splits the text into roughly equal chunks, moving every split point forward to the start of a game
+	std::vector<std::string_view> splitAtGameBoundaries(std::string_view text, size_t chunkCount) {
+		constexpr std::string_view GAME_BEGIN = "\n[Event ";
+
+		std::vector<std::string_view> ret;
+		auto chunkSize = std::max(text.size() / chunkCount, 1uz);
+		auto chunkBegin = 0uz;
+		while (chunkBegin < text.size()) {
+			auto splitPoint = text.find(GAME_BEGIN, std::min(chunkBegin + chunkSize, text.size()));
+			auto chunkEnd = (splitPoint == std::string_view::npos) ? text.size() : splitPoint + 1;
+			ret.push_back(text.substr(chunkBegin, chunkEnd - chunkBegin));
+			chunkBegin = chunkEnd;
+		}
+		return ret;
+	}
+
+	PGNStats readPGNFile(const std::filesystem::path& path, const PGNPositionCallback& onPosition) {
+		MemoryMappedFile file{ path };
+
+		BS::thread_pool<> pool{ std::thread::hardware_concurrency() };
+		for (auto threadID : pool.get_thread_ids()) {
+			arena::registerThread(threadID);
+		}
+
+		constexpr auto CHUNKS_PER_THREAD = 8uz; //smaller chunks balance the load when games vary in length
+		auto chunks = splitAtGameBoundaries(file.getText(), pool.get_thread_count() * CHUNKS_PER_THREAD);
+
+		auto chunkStats = pool.submit_sequence(0uz, chunks.size(), [&](size_t i) {
+			PGNStats stats;
+			for (const auto& pgnPosition : readPGNPositions(chunks[i], stats)) {
+				onPosition(pgnPosition);
+			}
+			arena::resetThread();
+			return stats;
+		}).get();
+
+		return std::ranges::fold_left(chunkStats, PGNStats{}, [](PGNStats acc, const PGNStats& stats) {
+			acc.gameCount += stats.gameCount;
+			acc.positionCount += stats.positionCount;
+			acc.unreadableGameCount += stats.unreadableGameCount;
+			return acc;
+		});
+	}
+}
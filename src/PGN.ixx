@@ -0,0 +1,37 @@
+export module Chess.PGN;
+
+import std;
+
+export import Chess.Position;
+
+export namespace chess {
+	enum class PGNResult : std::uint8_t {
+		WhiteWins,
+		BlackWins,
+		Draw,
+		Unknown
+	};
+
+	struct PGNPosition {
+		Position pos;
+		PGNResult result = PGNResult::Unknown;
+		int ply = 0;
+	};
+
+	struct PGNStats {
+		size_t gameCount = 0;
+		size_t positionCount = 0;
+		size_t unreadableGameCount = 0; //games containing a move that is illegal or can't be resolved
+	};
+
+	//yields every position of every game in the text, starting with each game's initial position. Games without a Result
+	//tag are yielded once their termination marker is reached, so that every position carries the result.
+	//Must be run on a thread registered with the arena.
+	std::generator<const PGNPosition&> readPGNPositions(std::string_view text, PGNStats& stats);
+
+	using PGNPositionCallback = std::function<void(const PGNPosition&)>;
+
+	//memory maps the file and reads it on every core, splitting the work at game boundaries. 
+	//The callback is invoked concurrently from multiple threads.
+	PGNStats readPGNFile(const std::filesystem::path& path, const PGNPositionCallback& onPosition);
+}
@@ -0,0 +1,36 @@
+module Chess.PackedPosition;
+
+import Chess.MemoryMappedFile;
+
+namespace chess {
+	PackedPositionWriter::PackedPositionWriter(std::ofstream& file, std::mutex& fileMutex) : m_file{ file }, m_fileMutex{ fileMutex } {
+		m_buffer.reserve(FLUSH_POSITION_COUNT);
+	}
+
+	void PackedPositionWriter::write(std::span<const PackedPosition> positions) {
+		m_buffer.insert(m_buffer.end(), positions.begin(), positions.end());
+		if (m_buffer.size() >= FLUSH_POSITION_COUNT) {
+			flush();
+		}
+	}
+
+	void PackedPositionWriter::flush() {
+		std::scoped_lock l{ m_fileMutex };
+		m_file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size() * sizeof(PackedPosition)));
+		m_buffer.clear();
+	}
+
+	std::generator<std::span<const PackedPosition>> readPackedPositions(std::filesystem::path path, size_t batchSize) {
+		MemoryMappedFile file{ path };
+		auto bytes = file.getBytes();
+		if (bytes.size() % sizeof(PackedPosition) != 0) {
+			std::println("Warning: {} has {} trailing bytes, which will be ignored", path.string(), bytes.size() % sizeof(PackedPosition));
+		}
+
+		//mappings are page aligned, so the records are correctly aligned too
+		std::span positions{ reinterpret_cast<const PackedPosition*>(bytes.data()), bytes.size() / sizeof(PackedPosition) };
+		for (auto batch : positions | std::views::chunk(batchSize)) {
+			co_yield std::span{ batch };
+		}
+	}
+}
@@ -0,0 +1,53 @@
+export module Chess.PackedPosition;
+
+import std;
+
+export namespace chess {
+	//fixed size binary encoding of a position, shared by every tool that stores positions in bulk.
+	//Pieces are stored as one nibble per occupied square, in square order: the piece type, plus 8 for black pieces.
+	struct PackedPosition {
+		static constexpr std::uint8_t WHITE_TO_MOVE_FLAG = 1;
+		static constexpr std::uint8_t WHITE_KINGSIDE_FLAG = 1 << 1;
+		static constexpr std::uint8_t WHITE_QUEENSIDE_FLAG = 1 << 2;
+		static constexpr std::uint8_t BLACK_KINGSIDE_FLAG = 1 << 3;
+		static constexpr std::uint8_t BLACK_QUEENSIDE_FLAG = 1 << 4;
+		static constexpr std::uint8_t NO_EN_PASSANT_SQUARE = 64;
+
+		std::uint64_t occupancy = 0;
+		std::array<std::uint8_t, 16> pieces{};
+		std::uint8_t flags = 0;
+		std::uint8_t enPassantSquare = NO_EN_PASSANT_SQUARE;
+		std::uint8_t halfmoveClock = 0;
+
+		//training labels, left as 0 when a position isn't labelled
+		std::int8_t result = 0; //1 if white won, 0 if drawn, -1 if black won
+		std::int16_t score = 0; //centipawns, from white's perspective
+
+		std::array<std::uint8_t, 2> reserved{};
+
+		bool operator==(const PackedPosition&) const = default;
+	};
+	static_assert(sizeof(PackedPosition) == 32);
+	static_assert(std::is_trivially_copyable_v<PackedPosition>);
+
+	//appends positions to a file in large blocks
+	class PackedPositionWriter {
+	private:
+		static constexpr auto FLUSH_POSITION_COUNT = 32768uz;
+
+		std::ofstream& m_file;
+		std::mutex& m_fileMutex;
+		std::vector<PackedPosition> m_buffer;
+	public:
+		//the mutex guards the file, so that several writers can share it
+		PackedPositionWriter(std::ofstream& file, std::mutex& fileMutex);
+		PackedPositionWriter(PackedPositionWriter&&) = default;
+
+		void write(std::span<const PackedPosition> positions);
+		void flush();
+	};
+
+	//memory maps the file and yields its positions in batches of at most batchSize.
+	//The spans point straight into the mapping and are only valid until the next batch.
+	std::generator<std::span<const PackedPosition>> readPackedPositions(std::filesystem::path path, size_t batchSize = 65536);
+}
@@ -0,0 +1,122 @@
+module;
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+module Chess.PerfCounters;
+
+namespace chess::perf {
+	std::atomic_bool enabled = false;
+
+	void setEnabled(bool value) {
+		enabled.store(value, std::memory_order_relaxed);
+	}
+
+	bool isEnabled() {
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+#ifdef __linux__
+	struct EventConfig {
+		std::uint32_t type = 0;
+		std::uint64_t config = 0;
+	};
+
+	constexpr std::uint64_t makeCacheReadMissConfig(std::uint64_t cache) {
+		return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	}
+
+	constexpr std::array<EventConfig, EVENT_COUNT> EVENT_CONFIGS{ {
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HW_CACHE, makeCacheReadMissConfig(PERF_COUNT_HW_CACHE_L1D) },
+		{ PERF_TYPE_HW_CACHE, makeCacheReadMissConfig(PERF_COUNT_HW_CACHE_LL) },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+	} };
+
+	//one counter group per thread, so every event is scheduled onto the PMU together and the ratios between them are meaningful
+	class CounterGroup {
+	private:
+		std::vector<int> m_fds;
+		std::vector<Event> m_events; //the events that opened, in group read order
+	public:
+		CounterGroup() {
+			for (auto i = 0uz; i < EVENT_COUNT; i++) {
+				perf_event_attr attr{};
+				attr.size = sizeof(attr);
+				attr.type = EVENT_CONFIGS[i].type;
+				attr.config = EVENT_CONFIGS[i].config;
+				attr.exclude_kernel = 1;
+				attr.exclude_hv = 1;
+				attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+				auto groupFd = m_fds.empty() ? -1 : m_fds.front();
+				auto fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0)); //this thread, any CPU
+				if (fd == -1) {
+					continue; //e.g. virtual machines often don't expose cache events
+				}
+				m_fds.push_back(fd);
+				m_events.push_back(static_cast<Event>(i));
+			}
+		}
+		CounterGroup(const CounterGroup&) = delete;
+		CounterGroup& operator=(const CounterGroup&) = delete;
+
+		~CounterGroup() {
+			for (auto fd : m_fds) {
+				close(fd);
+			}
+		}
+
+		bool isOpen() const {
+			return !m_fds.empty();
+		}
+
+		CounterValues read() const {
+			CounterValues ret;
+			if (!isOpen()) {
+				return ret;
+			}
+
+			//layout of a PERF_FORMAT_GROUP read: count, time enabled, time running, then one value per event
+			std::array<std::uint64_t, 3 + EVENT_COUNT> buffer{};
+			if (::read(m_fds.front(), buffer.data(), sizeof(buffer)) <= 0) {
+				return ret;
+			}
+			auto [count, timeEnabled, timeRunning] = std::tuple{ buffer[0], buffer[1], buffer[2] };
+
+			//if the PMU was shared with other groups, the counts only cover the time this group was scheduled
+			auto scale = timeRunning == 0 ? 0.0 : static_cast<double>(timeEnabled) / static_cast<double>(timeRunning);
+			for (auto i = 0uz; i < std::min<size_t>(count, m_events.size()); i++) {
+				ret[m_events[i]] = static_cast<std::uint64_t>(static_cast<double>(buffer[3 + i]) * scale);
+			}
+			return ret;
+		}
+	};
+
+	const CounterGroup& getThreadCounterGroup() {
+		thread_local CounterGroup group;
+		return group;
+	}
+
+	bool isAvailable() {
+		return getThreadCounterGroup().isOpen();
+	}
+
+	CounterValues readThreadCounters() {
+		return getThreadCounterGroup().read();
+	}
+#else
+	bool isAvailable() {
+		return false;
+	}
+
+	CounterValues readThreadCounters() {
+		return {};
+	}
+#endif
+}
@@ -0,0 +1,63 @@
+export module Chess.PerfCounters;
+
+import std;
+
+export namespace chess::perf {
+	enum class Event : std::uint8_t {
+		Cycles,
+		Instructions,
+		L1DMisses,
+		LLCMisses,
+		BranchMisses,
+		Count
+	};
+	constexpr auto EVENT_COUNT = static_cast<size_t>(Event::Count);
+
+	constexpr std::array<std::string_view, EVENT_COUNT> EVENT_NAMES{
+		"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+	};
+
+	struct CounterValues {
+		std::array<std::uint64_t, EVENT_COUNT> values{};
+
+		std::uint64_t operator[](Event event) const {
+			return values[static_cast<size_t>(event)];
+		}
+		std::uint64_t& operator[](Event event) {
+			return values[static_cast<size_t>(event)];
+		}
+
+		CounterValues& operator+=(const CounterValues& other) {
+			for (auto i = 0uz; i < EVENT_COUNT; i++) {
+				values[i] += other.values[i];
+			}
+			return *this;
+		}
+		CounterValues operator-(const CounterValues& other) const {
+			CounterValues ret;
+			for (auto i = 0uz; i < EVENT_COUNT; i++) {
+				ret.values[i] = values[i] >= other.values[i] ? values[i] - other.values[i] : 0;
+			}
+			return ret;
+		}
+
+		double instructionsPerCycle() const {
+			return (*this)[Event::Cycles] == 0 ? 0.0 : static_cast<double>((*this)[Event::Instructions]) / static_cast<double>((*this)[Event::Cycles]);
+		}
+		double perOperation(Event event, std::uint64_t operationCount) const {
+			return operationCount == 0 ? 0.0 : static_cast<double>((*this)[event]) / static_cast<double>(operationCount);
+		}
+	};
+
+	//counting is off until enabled, so that production searches make no extra system calls
+	void setEnabled(bool enabled);
+	bool isEnabled();
+
+	//true if the calling thread's counters could be opened. Always false on platforms other than Linux, or when
+	//perf_event_paranoid forbids user space counting.
+	bool isAvailable();
+
+	//user space totals for the calling thread since its counters were opened. Counters the CPU doesn't support stay at 0.
+	//Opens the counters on first use. Costs a system call, so read around whole phases rather than individual calls.
+	CounterValues readThreadCounters();
+}
@@ -12,17 +12,274 @@ import :Zobrist;
 
 namespace chess {
     void Position::setPos(const PositionCommand& positionCommand) {
-        m_whitePieces.clear();
-        m_blackPieces.clear();
+        auto& [white, black] = m_sides;
+        white.clear();
+        black.clear();
 
-        parseBoard(positionCommand.board, m_whitePieces, m_blackPieces);
-        m_isWhiteMoving = (positionCommand.color == 'w');
-        parseCastlingPrivileges(positionCommand.castlingPrivileges, m_whitePieces, m_blackPieces);
-        parseEnPessantSquare(positionCommand.enPessantSquare, m_isWhiteMoving, m_isWhiteMoving ? m_blackPieces : m_whitePieces);
+        parseBoard(positionCommand.board, white, black);
+        m_sideToMove = sideIndex(positionCommand.color == 'w');
+        parseCastlingPrivileges(positionCommand.castlingPrivileges, white, black);
+        parseEnPessantSquare(positionCommand.enPessantSquare, isWhite(), getTurnData().enemies);
+        m_halfmoveClock = positionCommand.halfmoveClock;
+        m_fullmoveNumber = positionCommand.fullmoveNumber;
 
         m_zobristHash = getStartingZobristHash(*this);
     }
 
+    void Position::setPos(const PackedPosition& packedPosition) {
+        auto& [white, black] = m_sides;
+        white.clear();
+        black.clear();
+
+        auto occupied = packedPosition.occupancy;
+        auto square = Square::None;
+        auto pieceIndex = 0uz;
+        while (nextSquare(occupied, square)) {
+            auto code = (packedPosition.pieces[pieceIndex / 2] >> (4 * (pieceIndex % 2))) & 0xF;
+            auto& pieces = (code & 8) ? black : white;
+            addSquare(pieces[static_cast<Piece>(code & 7)], square);
+            pieceIndex++;
+        }
+
+        m_sideToMove = sideIndex((packedPosition.flags & PackedPosition::WHITE_TO_MOVE_FLAG) != 0);
+        auto setCastling = [&](PieceState& pieces, std::uint8_t kingsideFlag, std::uint8_t queensideFlag) {
+            if (!(packedPosition.flags & kingsideFlag)) {
+                pieces.castling.disallowKingsideCastling();
+            }
+            if (!(packedPosition.flags & queensideFlag)) {
+                pieces.castling.disallowQueensideCastling();
+            }
+        };
+        setCastling(white, PackedPosition::WHITE_KINGSIDE_FLAG, PackedPosition::WHITE_QUEENSIDE_FLAG);
+        setCastling(black, PackedPosition::BLACK_KINGSIDE_FLAG, PackedPosition::BLACK_QUEENSIDE_FLAG);
+
+        if (packedPosition.enPassantSquare != PackedPosition::NO_EN_PASSANT_SQUARE) {
+            auto enPassantSquare = static_cast<Square>(packedPosition.enPassantSquare);
+            getTurnData().enemies.doubleJumpedPawn = isWhite() ? southSquare(enPassantSquare) : northSquare(enPassantSquare);
+        }
+        m_halfmoveClock = packedPosition.halfmoveClock;
+        m_fullmoveNumber = 1; //not packed
+
+        m_zobristHash = getStartingZobristHash(*this);
+    }
+
+    //splits off the next space separated field, or returns an empty view when there are none left
+    static std::string_view nextFENField(std::string_view& fen) {
+        auto start = fen.find_first_not_of(' ');
+        if (start == std::string_view::npos) {
+            fen = {};
+            return {};
+        }
+        fen.remove_prefix(start);
+        auto end = std::min(fen.find(' '), fen.size());
+        auto field = fen.substr(0, end);
+        fen.remove_prefix(end);
+        return field;
+    }
+
+    static std::optional<Piece> parseFENPiece(char chr) {
+        switch (chr | 0x20) { //lowercase
+        case 'k': return King;
+        case 'q': return Queen;
+        case 'r': return Rook;
+        case 'b': return Bishop;
+        case 'n': return Knight;
+        case 'p': return Pawn;
+        default: return std::nullopt;
+        }
+    }
+
+    static bool parseFENBoard(std::string_view board, PieceState& white, PieceState& black) {
+        auto rank = 7;
+        auto file = 0;
+        for (auto chr : board) {
+            if (chr == '/') {
+                if (file != 8 || rank == 0) {
+                    return false;
+                }
+                rank--;
+                file = 0;
+            } else if (chr >= '1' && chr <= '8') {
+                file += chr - '0';
+                if (file > 8) {
+                    return false;
+                }
+            } else if (auto piece = parseFENPiece(chr); piece && file < 8) {
+                auto& pieces = (chr >= 'a') ? black : white;
+                addSquare(pieces[*piece], static_cast<Square>(rank * 8 + file));
+                file++;
+            } else {
+                return false;
+            }
+        }
+        return rank == 0 && file == 8;
+    }
+
+    static bool parseFENCastling(std::string_view castling, PieceState& white, PieceState& black) {
+        auto whiteKingside = false, whiteQueenside = false, blackKingside = false, blackQueenside = false;
+        if (castling != "-") {
+            for (auto chr : castling) {
+                switch (chr) {
+                case 'K': whiteKingside = true; break;
+                case 'Q': whiteQueenside = true; break;
+                case 'k': blackKingside = true; break;
+                case 'q': blackQueenside = true; break;
+                default: return false;
+                }
+            }
+        }
+
+        //both sides start out able to castle, so only take away the missing privileges
+        auto disallow = [](PieceState& pieces, bool kingside, bool queenside) {
+            if (!kingside) {
+                pieces.castling.disallowKingsideCastling();
+            }
+            if (!queenside) {
+                pieces.castling.disallowQueensideCastling();
+            }
+        };
+        disallow(white, whiteKingside, whiteQueenside);
+        disallow(black, blackKingside, blackQueenside);
+        return !castling.empty();
+    }
+
+    template<std::integral T>
+    static std::optional<T> parseFENNumber(std::string_view field, T min) {
+        T value{};
+        auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+        if (ec != std::errc{} || ptr != field.data() + field.size() || value < min) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    std::expected<void, FENError> Position::setFEN(std::string_view fen) {
+        auto boardField = nextFENField(fen);
+        auto colorField = nextFENField(fen);
+        auto castlingField = nextFENField(fen);
+        auto enPassantField = nextFENField(fen);
+        auto halfmoveField = nextFENField(fen);
+        auto fullmoveField = nextFENField(fen);
+        if (enPassantField.empty()) {
+            return std::unexpected{ FENError::MissingField };
+        }
+
+        //parse into a copy of the sides so that a bad fen leaves the position untouched
+        std::array<PieceState, 2> sides;
+        auto& [white, black] = sides;
+        white.clear();
+        black.clear();
+
+        if (!parseFENBoard(boardField, white, black)) {
+            return std::unexpected{ FENError::InvalidBoard };
+        }
+        if (std::popcount(white[King]) != 1 || std::popcount(black[King]) != 1) {
+            return std::unexpected{ FENError::InvalidKingCount };
+        }
+
+        if (colorField != "w" && colorField != "b") {
+            return std::unexpected{ FENError::InvalidSideToMove };
+        }
+        auto isWhiteToMove = colorField == "w";
+
+        if (!parseFENCastling(castlingField, white, black)) {
+            return std::unexpected{ FENError::InvalidCastling };
+        }
+
+        if (enPassantField != "-") {
+            auto enPassantSquare = parseSquare(enPassantField);
+            if (!enPassantSquare || rankOf(*enPassantSquare) != (isWhiteToMove ? 5 : 2)) {
+                return std::unexpected{ FENError::InvalidEnPassant };
+            }
+            auto& enemies = isWhiteToMove ? black : white;
+            auto jumpedPawn = isWhiteToMove ? southSquare(*enPassantSquare) : northSquare(*enPassantSquare);
+            if (!containsSquare(enemies[Pawn], jumpedPawn)) {
+                return std::unexpected{ FENError::InvalidEnPassant };
+            }
+            enemies.doubleJumpedPawn = jumpedPawn;
+        }
+
+        std::uint8_t halfmoveClock = 0;
+        if (!halfmoveField.empty()) {
+            auto parsed = parseFENNumber<std::uint8_t>(halfmoveField, 0);
+            if (!parsed) {
+                return std::unexpected{ FENError::InvalidHalfmoveClock };
+            }
+            halfmoveClock = *parsed;
+        }
+
+        std::uint16_t fullmoveNumber = 1;
+        if (!fullmoveField.empty()) {
+            auto parsed = parseFENNumber<std::uint16_t>(fullmoveField, 1);
+            if (!parsed) {
+                return std::unexpected{ FENError::InvalidFullmoveNumber };
+            }
+            fullmoveNumber = *parsed;
+        }
+
+        m_sides = sides;
+        m_sideToMove = sideIndex(isWhiteToMove);
+        m_halfmoveClock = halfmoveClock;
+        m_fullmoveNumber = fullmoveNumber;
+        m_zobristHash = getStartingZobristHash(*this);
+        return {};
+    }
+
+    std::string Position::toFEN() const {
+        std::array<char, MAX_FEN_LENGTH> buffer;
+        auto end = writeFEN(buffer.begin());
+        return std::string{ buffer.begin(), end };
+    }
+
+    PackedPosition Position::pack() const {
+        PackedPosition ret;
+
+        SquareMap<std::uint8_t> pieceCodes{};
+        auto addPieces = [&](Bitboard pieceLocations, Piece pieceType, bool isWhite) {
+            ret.occupancy |= pieceLocations;
+            auto square = Square::None;
+            while (nextSquare(pieceLocations, square)) {
+                pieceCodes[square] = static_cast<std::uint8_t>(pieceType | (isWhite ? 0 : 8));
+            }
+        };
+        const auto& [white, black] = m_sides;
+        for (auto piece : ALL_PIECE_TYPES) {
+            addPieces(white[piece], piece, true);
+            addPieces(black[piece], piece, false);
+        }
+
+        auto occupied = ret.occupancy;
+        auto square = Square::None;
+        auto pieceIndex = 0uz;
+        while (nextSquare(occupied, square)) {
+            ret.pieces[pieceIndex / 2] |= static_cast<std::uint8_t>(pieceCodes[square] << (4 * (pieceIndex % 2)));
+            pieceIndex++;
+        }
+
+        auto setFlag = [&ret](bool condition, std::uint8_t flag) {
+            if (condition) {
+                ret.flags |= flag;
+            }
+        };
+        setFlag(isWhite(), PackedPosition::WHITE_TO_MOVE_FLAG);
+        setFlag(white.castling.canCastleKingside(), PackedPosition::WHITE_KINGSIDE_FLAG);
+        setFlag(white.castling.canCastleQueenside(), PackedPosition::WHITE_QUEENSIDE_FLAG);
+        setFlag(black.castling.canCastleKingside(), PackedPosition::BLACK_KINGSIDE_FLAG);
+        setFlag(black.castling.canCastleQueenside(), PackedPosition::BLACK_QUEENSIDE_FLAG);
+
+        auto jumpedPawn = getTurnData().enemies.doubleJumpedPawn;
+        if (jumpedPawn != Square::None) {
+            auto enPassantSquare = isWhite() ? northSquare(jumpedPawn) : southSquare(jumpedPawn);
+            ret.enPassantSquare = static_cast<std::uint8_t>(enPassantSquare);
+        }
+        ret.halfmoveClock = m_halfmoveClock;
+        return ret;
+    }
+
+    std::uint64_t Position::polyglotHash() const {
+        return getPolyglotHash(*this);
+    }
+
     bool Position::tryCastle(Position::MutableTurnData& turnData, const Move& move) {
         //if we can't castle eitherway or we're just not moving the king, don't try to castle
         if ((!turnData.allies.castling.canCastleKingside() && !turnData.allies.castling.canCastleQueenside()) || move.movedPiece != King) {
@@ -33,11 +290,11 @@ namespace chess {
         turnData.allies.castling.disallowQueensideCastling();
         turnData.allies.castling.disallowKingsideCastling();
 
-        auto updateZobrist = [&move, this](Square rookFrom, Square rookTo) {
-            m_zobristHash ^= getZobristPieceCode(move.from, King, m_isWhiteMoving);
-            m_zobristHash ^= getZobristPieceCode(move.to, King, m_isWhiteMoving);
-            m_zobristHash ^= getZobristPieceCode(rookFrom, Rook, m_isWhiteMoving);
-            m_zobristHash ^= getZobristPieceCode(rookTo, Rook, m_isWhiteMoving);
+        auto updateZobrist = [&move, &turnData, this](Square rookFrom, Square rookTo) {
+            m_zobristHash ^= getZobristPieceCode(move.from, King, turnData.isWhite);
+            m_zobristHash ^= getZobristPieceCode(move.to, King, turnData.isWhite);
+            m_zobristHash ^= getZobristPieceCode(rookFrom, Rook, turnData.isWhite);
+            m_zobristHash ^= getZobristPieceCode(rookTo, Rook, turnData.isWhite);
         };
         if (turnData.allyKingside.kingTo == move.to) {
             moveSquare(turnData.allies[King], move.from, turnData.allyKingside.kingTo);
@@ -101,7 +358,7 @@ namespace chess {
         //move the piece (destination square handled with pawn promotions)
         auto& movedPiecePos = turnData.allies[move.movedPiece];
         removeSquare(turnData.allies[move.movedPiece], move.from);
-        m_zobristHash ^= getZobristPieceCode(move.from, move.movedPiece, m_isWhiteMoving);
+        m_zobristHash ^= getZobristPieceCode(move.from, move.movedPiece, turnData.isWhite);
 
         //capture the piece!
         if (move.capturedPiece != Piece::None) {
@@ -112,30 +369,40 @@ namespace chess {
             movePawn(turnData, move, turnData.allies[Pawn]);
         } else {
             addSquare(movedPiecePos, move.to);
-            m_zobristHash ^= getZobristPieceCode(move.to, move.movedPiece, m_isWhiteMoving);
+            m_zobristHash ^= getZobristPieceCode(move.to, move.movedPiece, turnData.isWhite);
         }
     }
 
     void Position::move(const Move& move) {
         auto [white, black] = getColorSides();
         auto oldCastlingZobristCode = getZobristCastleCode(white.castling.get(), black.castling.get());
-        auto oldPlayerMover = m_isWhiteMoving;
+        auto oldPlayerMover = isWhite();
 
         auto turnData = getTurnData();
         if (!tryCastle(turnData, move)) {
             normalMove(turnData, move);
         }
 
+        if (move.movedPiece == Pawn || move.capturedPiece != Piece::None) {
+            m_halfmoveClock = 0;
+        } else if (m_halfmoveClock < std::numeric_limits<std::uint8_t>::max()) {
+            m_halfmoveClock++;
+        }
+
         //reset enemy jumped pawn
         if (turnData.enemies.doubleJumpedPawn != Square::None) {
             m_zobristHash ^= getZobristDoubleJumpSquareCode(turnData.enemies.doubleJumpedPawn); 
             turnData.enemies.doubleJumpedPawn = Square::None;
         }
 
+        if (!oldPlayerMover) {
+            m_fullmoveNumber++;
+        }
+
         //alternate turns
-        m_isWhiteMoving = !m_isWhiteMoving; 
+        m_sideToMove ^= 1; 
         m_zobristHash ^= getZobristTurnCode(oldPlayerMover);
-        m_zobristHash ^= getZobristTurnCode(m_isWhiteMoving);
+        m_zobristHash ^= getZobristTurnCode(isWhite());
 
         //update castling hash
         m_zobristHash ^= oldCastlingZobristCode;
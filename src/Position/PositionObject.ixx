@@ -3,11 +3,35 @@ export module Chess.Position:PositionObject;
 export import std;
 
 export import Chess.Move;
+export import Chess.PackedPosition;
+import Chess.Assert;
 import Chess.PositionCommand;
 import Chess.Position.PieceState;
 import Chess.RankCalculator;
 
 export namespace chess {
+	enum class FENError : std::uint8_t {
+		MissingField,
+		InvalidBoard,
+		InvalidKingCount,
+		InvalidSideToMove,
+		InvalidCastling,
+		InvalidEnPassant,
+		InvalidHalfmoveClock,
+		InvalidFullmoveNumber
+	};
+
+	constexpr std::string_view getFENErrorMessage(FENError error) {
+		constexpr std::array<std::string_view, 8> MESSAGES{
+			"fen needs at least 4 fields", "invalid board", "fen must have exactly one king per side", "invalid side to move",
+			"invalid castling rights", "invalid en passant square", "invalid halfmove clock", "invalid fullmove number"
+		};
+		return MESSAGES[static_cast<size_t>(error)];
+	}
+
+	//longest possible FEN, e.g. "1n1n1n1n/..." for every rank plus the longest state fields
+	constexpr size_t MAX_FEN_LENGTH = 92;
+
 	class Position {
 	private:
 		struct CastleMove {
@@ -22,6 +46,19 @@ export namespace chess {
 		static constexpr CastleMove BLACK_KINGSIDE = {Square::G8, Square::H8, Square::F8, makeBitboard(Square::F8, Square::G8), makeBitboard(Square::F8, Square::G8) };
 		static constexpr CastleMove BLACK_QUEENSIDE = {Square::C8, Square::A8, Square::D8, makeBitboard(Square::B8, Square::C8, Square::D8), makeBitboard(Square::C8, Square::D8) };
 
+		struct SideConstants {
+			CastleMove kingside;
+			CastleMove queenside;
+			Bitboard pawnRank = 0;
+			Bitboard jumpedPawnRank = 0;
+		};
+		static constexpr std::uint8_t WHITE_INDEX = 0;
+		static constexpr std::uint8_t BLACK_INDEX = 1;
+		static constexpr std::array<SideConstants, 2> SIDE_CONSTANTS{ {
+			{ WHITE_KINGSIDE, WHITE_QUEENSIDE, calcRank<2>(), calcRank<4>() },
+			{ BLACK_KINGSIDE, BLACK_QUEENSIDE, calcRank<7>(), calcRank<5>() }
+		} };
+
 		template<typename MaybeConstPieceState>
 		struct TurnData {
 			MaybeConstPieceState& allies;
@@ -38,30 +75,28 @@ export namespace chess {
 		using MutableTurnData = TurnData<PieceState>;
 		using ImmutableTurnData = TurnData<const PieceState>;
 	private:
-		PieceState m_whitePieces;
-		PieceState m_blackPieces;
-		bool m_isWhiteMoving = true;
 		std::uint64_t m_zobristHash = 0;
+		std::array<PieceState, 2> m_sides; //indexed by WHITE_INDEX and BLACK_INDEX
+		std::uint8_t m_sideToMove = WHITE_INDEX;
+		std::uint8_t m_halfmoveClock = 0; //not part of the hash, so it doesn't affect repetition detection
+		std::uint16_t m_fullmoveNumber = 1;
 
+		//no branches: the sides and their constants are looked up by index
 		template<typename MaybeConstPieceState>
-		TurnData<MaybeConstPieceState> getTurnDataImpl(this auto&& self) {
-			if (self.m_isWhiteMoving) {
-				return TurnData<MaybeConstPieceState>{
-					self.m_whitePieces, self.m_blackPieces,
-						WHITE_KINGSIDE, WHITE_QUEENSIDE,
-						BLACK_KINGSIDE, BLACK_QUEENSIDE,
-						self.m_isWhiteMoving,
-						calcRank<2>(), calcRank<4>()
-				};
-			} else {
-				return TurnData<MaybeConstPieceState>{
-					self.m_blackPieces, self.m_whitePieces,
-						BLACK_KINGSIDE, BLACK_QUEENSIDE,
-						WHITE_KINGSIDE, WHITE_QUEENSIDE,
-						self.m_isWhiteMoving,
-						calcRank<7>(), calcRank<5>()
-				};
-			}
+		TurnData<MaybeConstPieceState> makeTurnData(this auto&& self, size_t allyIndex) {
+			auto enemyIndex = allyIndex ^ 1;
+			const auto& ally = SIDE_CONSTANTS[allyIndex];
+			const auto& enemy = SIDE_CONSTANTS[enemyIndex];
+			return TurnData<MaybeConstPieceState>{
+				self.m_sides[allyIndex], self.m_sides[enemyIndex],
+					ally.kingside, ally.queenside,
+					enemy.kingside, enemy.queenside,
+					allyIndex == WHITE_INDEX,
+					ally.pawnRank, ally.jumpedPawnRank
+			};
+		}
+		static constexpr std::uint8_t sideIndex(bool isWhite) {
+			return isWhite ? WHITE_INDEX : BLACK_INDEX;
 		}
 		bool tryCastle(MutableTurnData& turnData, const Move& move);
 		void movePawn(const MutableTurnData& turnData, const Move& move, Bitboard& pawns);
@@ -79,6 +114,84 @@ export namespace chess {
 		}
 
 		void setPos(const PositionCommand& positionCommand);
+		void setPos(const PackedPosition& packedPosition);
+		PackedPosition pack() const;
+
+		//doesn't allocate. The halfmove clock and fullmove number are optional, and the position is unchanged on error.
+		std::expected<void, FENError> setFEN(std::string_view fen);
+
+		//writes the FEN without allocating. out must have room for MAX_FEN_LENGTH characters.
+		template<std::output_iterator<char> Out>
+		Out writeFEN(Out out) const {
+			constexpr std::string_view PIECE_CHARS = "kqrbnp"; //in Piece order
+
+			std::array<char, 64> board{};
+			for (auto side : { WHITE_INDEX, BLACK_INDEX }) {
+				for (auto piece : ALL_PIECE_TYPES) {
+					auto locations = m_sides[side][piece];
+					auto square = Square::None;
+					while (nextSquare(locations, square)) {
+						auto chr = PIECE_CHARS[piece];
+						board[static_cast<size_t>(square)] = side == WHITE_INDEX ? static_cast<char>(chr - 'a' + 'A') : chr;
+					}
+				}
+			}
+
+			for (int rank = 7; rank >= 0; rank--) {
+				auto emptySquares = 0;
+				for (int file = 0; file < 8; file++) {
+					auto chr = board[static_cast<size_t>(rank * 8 + file)];
+					if (chr == 0) {
+						emptySquares++;
+						continue;
+					}
+					if (emptySquares > 0) {
+						*out++ = static_cast<char>('0' + emptySquares);
+						emptySquares = 0;
+					}
+					*out++ = chr;
+				}
+				if (emptySquares > 0) {
+					*out++ = static_cast<char>('0' + emptySquares);
+				}
+				if (rank > 0) {
+					*out++ = '/';
+				}
+			}
+
+			*out++ = ' ';
+			*out++ = isWhite() ? 'w' : 'b';
+			*out++ = ' ';
+
+			const auto& [white, black] = m_sides;
+			auto hasCastlingRights = false;
+			auto writeCastlingRight = [&](bool canCastle, char chr) {
+				if (canCastle) {
+					*out++ = chr;
+					hasCastlingRights = true;
+				}
+			};
+			writeCastlingRight(white.castling.canCastleKingside(), 'K');
+			writeCastlingRight(white.castling.canCastleQueenside(), 'Q');
+			writeCastlingRight(black.castling.canCastleKingside(), 'k');
+			writeCastlingRight(black.castling.canCastleQueenside(), 'q');
+			if (!hasCastlingRights) {
+				*out++ = '-';
+			}
+			*out++ = ' ';
+
+			auto jumpedPawn = getTurnData().enemies.doubleJumpedPawn;
+			if (jumpedPawn != Square::None) {
+				auto enPassantSquare = isWhite() ? northSquare(jumpedPawn) : southSquare(jumpedPawn);
+				*out++ = static_cast<char>('a' + fileOf(enPassantSquare));
+				*out++ = static_cast<char>('1' + rankOf(enPassantSquare));
+			} else {
+				*out++ = '-';
+			}
+
+			return std::format_to(out, " {} {}", m_halfmoveClock, m_fullmoveNumber);
+		}
+		std::string toFEN() const;
 
 		void move(const Move& move);
 		void move(std::string_view moveStr);
@@ -86,26 +199,47 @@ export namespace chess {
 		size_t hash() const {
 			return m_zobristHash;
 		}
+		std::uint64_t polyglotHash() const;
+
+		TurnData<const PieceState> getTurnData() const {
+			return makeTurnData<const PieceState>(m_sideToMove);
+		}
+		TurnData<PieceState> getTurnData() {
+			return makeTurnData<PieceState>(m_sideToMove);
+		}
 
+		//for callers that already know the side to move, so the sides are resolved at compile time
+		template<bool IsWhite>
 		TurnData<const PieceState> getTurnData() const {
-			return getTurnDataImpl<const PieceState>();
+			zAssert(isWhite() == IsWhite);
+			return makeTurnData<const PieceState>(sideIndex(IsWhite));
 		}
+		template<bool IsWhite>
 		TurnData<PieceState> getTurnData() {
-			return getTurnDataImpl<PieceState>();
+			zAssert(isWhite() == IsWhite);
+			return makeTurnData<PieceState>(sideIndex(IsWhite));
 		}
 
 		template<bool Maximizing = true>
 		auto getColorSides(this auto&& self) {
 			if constexpr (Maximizing) {
-				return std::tie(self.m_whitePieces, self.m_blackPieces);
+				return std::tie(self.m_sides[WHITE_INDEX], self.m_sides[BLACK_INDEX]);
 			}
 			else {
-				return std::tie(self.m_blackPieces, self.m_whitePieces);
+				return std::tie(self.m_sides[BLACK_INDEX], self.m_sides[WHITE_INDEX]);
 			}
 		}
 
 		bool isWhite() const {
-			return m_isWhiteMoving;
+			return m_sideToMove == WHITE_INDEX;
+		}
+
+		std::uint8_t halfmoveClock() const {
+			return m_halfmoveClock;
+		}
+
+		std::uint16_t fullmoveNumber() const {
+			return m_fullmoveNumber;
 		}
 
 		int pieceCount() const {
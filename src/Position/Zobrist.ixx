@@ -14,4 +14,7 @@ export namespace chess {
 	std::uint64_t getZobristDoubleJumpSquareCode(Square doubleJumpedPawnSquare);
 	std::uint64_t getZobristTurnCode(bool isWhite);
 	std::uint64_t getStartingZobristHash(const Position& pos);
+
+	//key used by Polyglot opening books. Computed from scratch, since it is only needed at the root.
+	std::uint64_t getPolyglotHash(const Position& pos);
 }
\ No newline at end of file
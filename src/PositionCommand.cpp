@@ -29,8 +29,22 @@ namespace chess {
 			getFENTokens(iss);
 		}
 
-		//skip halfmove clock and fullmove number
-		while (iss >> token && token != "moves");
+		//read the halfmove clock and fullmove number if there are any
+		if (iss >> token && token != "moves") {
+			int halfmoveClock = 0;
+			auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), halfmoveClock);
+			if (ec == std::errc{}) {
+				ret.halfmoveClock = static_cast<std::uint8_t>(std::clamp(halfmoveClock, 0, 255));
+			}
+			if (iss >> token && token != "moves") {
+				int fullmoveNumber = 1;
+				auto [fullmovePtr, fullmoveEc] = std::from_chars(token.data(), token.data() + token.size(), fullmoveNumber);
+				if (fullmoveEc == std::errc{}) {
+					ret.fullmoveNumber = static_cast<std::uint16_t>(std::clamp(fullmoveNumber, 1, 65535));
+				}
+			}
+		}
+		while (token != "moves" && iss >> token);
 
 		if (token == "moves") {
 			while (iss >> token) {
@@ -10,6 +10,8 @@ export namespace chess {
 		char color = 'w';
 		std::string castlingPrivileges;
 		std::string enPessantSquare;
+		std::uint8_t halfmoveClock = 0;
+		std::uint16_t fullmoveNumber = 1;
 		std::vector<std::string> moves;
 	};
 
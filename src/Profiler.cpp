@@ -0,0 +1,87 @@
+module;
+
+#ifdef _WIN64
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+module Chess.Profiler;
+
+import nlohmann.json;
+
+import Chess.EnvironmentVariable;
+
+namespace chess::profiler {
+	struct ProfileRegistry {
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadProfile>> profiles; //never freed, so that profiles outlive their threads
+		std::uint64_t startTicks = __rdtsc();
+		std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	};
+
+	ProfileRegistry& getRegistry() {
+		static ProfileRegistry registry;
+		return registry;
+	}
+
+	ThreadProfile& getThreadProfile() {
+		thread_local ThreadProfile* profile = [] {
+			auto& registry = getRegistry();
+			std::scoped_lock l{ registry.mutex };
+			return registry.profiles.emplace_back(std::make_unique<ThreadProfile>()).get();
+		}();
+		return *profile;
+	}
+
+	//the TSC runs at a constant rate on every CPU we care about, so one measurement over the whole run is accurate enough
+	double calcNanosecondsPerTick(const ProfileRegistry& registry) {
+		auto ticks = __rdtsc() - registry.startTicks;
+		auto nanoseconds = std::chrono::duration<double, std::nano>{ std::chrono::steady_clock::now() - registry.startTime }.count();
+		return ticks == 0 ? 0.0 : nanoseconds / static_cast<double>(ticks);
+	}
+
+	void saveSession(std::string_view sessionName) {
+		auto& registry = getRegistry();
+		std::scoped_lock l{ registry.mutex };
+
+		ThreadProfile total;
+		for (const auto& profile : registry.profiles) {
+			for (auto zone = 0uz; zone < ZONE_COUNT; zone++) {
+				total.ticks[zone] += profile->ticks[zone];
+				total.counts[zone] += profile->counts[zone];
+				for (auto child = 0uz; child < ZONE_COUNT; child++) {
+					total.childTicks[zone][child] += profile->childTicks[zone][child];
+				}
+			}
+		}
+
+		auto nanosecondsPerTick = calcNanosecondsPerTick(registry);
+		auto session = nlohmann::json::array();
+		for (auto zone = 0uz; zone < ZONE_COUNT; zone++) {
+			nlohmann::json entry;
+			entry["name"] = ZONE_NAMES[zone];
+			entry["times_run"] = total.counts[zone];
+			entry["average_ns"] = total.counts[zone] == 0 ? 0 : 
+				static_cast<std::uint64_t>(static_cast<double>(total.ticks[zone]) * nanosecondsPerTick / static_cast<double>(total.counts[zone]));
+
+			nlohmann::json childPercentages = nullptr;
+			for (auto child = 0uz; child < ZONE_COUNT; child++) {
+				if (total.childTicks[zone][child] != 0) {
+					childPercentages[ZONE_NAMES[child]] = 100.0 * static_cast<double>(total.childTicks[zone][child]) / static_cast<double>(total.ticks[zone]);
+				}
+			}
+			entry["child_percentages"] = childPercentages;
+			session.push_back(entry);
+		}
+
+		auto path = getAssetDirectoryPath() / "profiling_sessions" / std::format("{}.json", sessionName);
+		std::ofstream file{ path };
+		if (!file.is_open()) {
+			std::println("Error: could not write profiling session {}", path.string());
+			return;
+		}
+		file << session.dump(2);
+		std::println("Saved profiling session to {}", path.string());
+	}
+}
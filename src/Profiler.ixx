@@ -0,0 +1,98 @@
+module;
+
+#ifdef _WIN64
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+export module Chess.Profiler;
+
+import std;
+
+export namespace chess::profiler {
+#ifdef USING_PROFILER
+	constexpr bool ENABLED = true;
+#else
+	constexpr bool ENABLED = false;
+#endif
+
+	enum class Zone : std::uint8_t {
+		Search,
+		MoveGeneration,
+		MoveOrdering,
+		Evaluation,
+		PositionTableProbe,
+		PositionTableStore,
+		NodeConstruction,
+		Count
+	};
+	constexpr auto ZONE_COUNT = static_cast<size_t>(Zone::Count);
+
+	//zones that cover a function from older profiling sessions keep that function's name, so the visualizer can compare them.
+	//Move generation was calcAllLegalMoves there; node construction is new.
+	constexpr std::array<std::string_view, ZONE_COUNT> ZONE_NAMES{
+		"findBestMove", "calcAllLegalMoves", "getMovePriorities", "staticEvaluation", "getPositionEntry", "storePositionEntry", "constructNode"
+	};
+
+	//owned by a single thread. Totals are in TSC ticks; childTicks[parent][child] is time spent in child while directly inside parent.
+	struct ThreadProfile {
+		static constexpr auto MAX_NESTING = 256uz;
+
+		std::array<std::uint64_t, ZONE_COUNT> ticks{};
+		std::array<std::uint64_t, ZONE_COUNT> counts{};
+		std::array<std::array<std::uint64_t, ZONE_COUNT>, ZONE_COUNT> childTicks{};
+
+		struct ActiveZone {
+			Zone zone = Zone::Count;
+			std::uint64_t start = 0;
+		};
+		std::array<ActiveZone, MAX_NESTING> stack{};
+		size_t stackSize = 0;
+	};
+
+	ThreadProfile& getThreadProfile();
+
+	//times its enclosing scope. Compiles to nothing unless USING_PROFILER is defined.
+	class ScopedZone {
+	private:
+		ThreadProfile* m_profile = nullptr;
+	public:
+		explicit ScopedZone(Zone zone) {
+			if constexpr (ENABLED) {
+				m_profile = &getThreadProfile();
+				if (m_profile->stackSize < ThreadProfile::MAX_NESTING) {
+					m_profile->stack[m_profile->stackSize] = { zone, __rdtsc() };
+				}
+				m_profile->stackSize++;
+			}
+		}
+		ScopedZone(const ScopedZone&) = delete;
+		ScopedZone& operator=(const ScopedZone&) = delete;
+
+		~ScopedZone() {
+			if constexpr (ENABLED) {
+				auto end = __rdtsc();
+				auto& profile = *m_profile;
+				profile.stackSize--;
+				if (profile.stackSize >= ThreadProfile::MAX_NESTING) {
+					return;
+				}
+
+				auto [zone, start] = profile.stack[profile.stackSize];
+				auto elapsed = end - start;
+				auto zoneIndex = static_cast<size_t>(zone);
+				profile.ticks[zoneIndex] += elapsed;
+				profile.counts[zoneIndex]++;
+				if (profile.stackSize > 0) {
+					auto parentIndex = static_cast<size_t>(profile.stack[profile.stackSize - 1].zone);
+					profile.childTicks[parentIndex][zoneIndex] += elapsed;
+				}
+			}
+		}
+	};
+
+	//merges every thread's profile and writes it to the profiling_sessions asset directory.
+	//Should only be called while no zones are running.
+	void saveSession(std::string_view sessionName);
+}
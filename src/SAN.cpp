@@ -0,0 +1,105 @@
+module Chess.SAN;
+
+namespace chess {
+	std::optional<Piece> parseSANPiece(char chr) {
+		switch (chr) {
+		case 'K':
+			return King;
+		case 'Q':
+			return Queen;
+		case 'R':
+			return Rook;
+		case 'B':
+			return Bishop;
+		case 'N':
+			return Knight;
+		default:
+			return std::nullopt;
+		}
+	}
+
+	std::string_view trimAnnotations(std::string_view san) {
+		while (!san.empty() && std::string_view{ "+#!?" }.contains(san.back())) {
+			san.remove_suffix(1);
+		}
+		return san;
+	}
+
+	std::optional<Move> findUniqueMove(std::span<const Move> legalMoves, auto pred) {
+		std::optional<Move> ret;
+		for (const auto& move : legalMoves) {
+			if (pred(move)) {
+				if (ret) { //ambiguous
+					return std::nullopt;
+				}
+				ret = move;
+			}
+		}
+		return ret;
+	}
+
+	std::optional<Move> parseCastle(std::string_view san, std::span<const Move> legalMoves) {
+		bool queenside = (san == "O-O-O" || san == "0-0-0");
+		return findUniqueMove(legalMoves, [&](const Move& move) {
+			if (move.movedPiece != King) {
+				return false;
+			}
+			auto fileChange = fileOf(move.to) - fileOf(move.from);
+			return queenside ? fileChange == -2 : fileChange == 2;
+		});
+	}
+
+	std::optional<Move> parseSANMove(std::string_view san, std::span<const Move> legalMoves) {
+		san = trimAnnotations(san);
+		if (san.starts_with("O-O") || san.starts_with("0-0")) {
+			return parseCastle(san, legalMoves);
+		}
+		if (san.empty()) {
+			return std::nullopt;
+		}
+
+		auto piece = Pawn;
+		if (auto sanPiece = parseSANPiece(san.front())) {
+			piece = *sanPiece;
+			san.remove_prefix(1);
+		}
+
+		auto promotionPiece = Piece::None;
+		if (piece == Pawn && !san.empty()) {
+			if (auto promotion = parseSANPiece(san.back()); promotion && *promotion != King) {
+				promotionPiece = *promotion;
+				san.remove_suffix(1);
+				if (san.ends_with('=')) {
+					san.remove_suffix(1);
+				}
+			}
+		}
+
+		if (san.size() < 2) {
+			return std::nullopt;
+		}
+		auto to = parseSquare(san.substr(san.size() - 2));
+		if (!to) {
+			return std::nullopt;
+		}
+		san.remove_suffix(2);
+
+		//whatever is left is the capture marker and the disambiguating file and/or rank
+		std::optional<int> fromFile;
+		std::optional<int> fromRank;
+		for (auto chr : san) {
+			if (chr >= 'a' && chr <= 'h') {
+				fromFile = chr - 'a';
+			} else if (chr >= '1' && chr <= '8') {
+				fromRank = chr - '1';
+			} else if (chr != 'x' && chr != ':') {
+				return std::nullopt;
+			}
+		}
+
+		return findUniqueMove(legalMoves, [&](const Move& move) {
+			return move.movedPiece == piece && move.to == *to && move.promotionPiece == promotionPiece &&
+				(!fromFile || fileOf(move.from) == *fromFile) && (!fromRank || rankOf(move.from) == *fromRank);
+		});
+	}
+}
@@ -0,0 +1,10 @@
+export module Chess.SAN;
+
+import std;
+
+export import Chess.Move;
+
+export namespace chess {
+	//resolves a standard algebraic notation move (e.g. "Nbxd7+", "O-O", "e8=Q") against the legal moves of a position
+	std::optional<Move> parseSANMove(std::string_view san, std::span<const Move> legalMoves);
+}
@@ -5,11 +5,21 @@ import std;
 import Chess.Assert;
 
 namespace chess {
-	export template<std::unsigned_integral T>
+	//Checked selects the build profile. The checked profile aborts when a contract is broken, while the unchecked
+	//profile compiles to plain integer arithmetic. Defaults to checked exactly when asserts are enabled.
+	export template<std::unsigned_integral T, bool Checked = ASSERTS_ENABLED>
 	class SafeUnsigned {
 	private:
 		static constexpr T MAX_VALUE = std::numeric_limits<T>::max();
 		T m_value;
+
+		//the condition isn't even evaluated in the unchecked profile
+		template<typename Condition>
+		static constexpr void check(Condition condition, std::source_location sl = std::source_location::current()) {
+			if constexpr (Checked) {
+				zCheck(condition(), sl);
+			}
+		}
 	public:
 		constexpr SafeUnsigned() : m_value{ 0 } {}
 		explicit constexpr SafeUnsigned(T t) : m_value{ t } {}
@@ -20,34 +30,34 @@ namespace chess {
 
 		constexpr SafeUnsigned& operator=(const SafeUnsigned&) = default;
 		constexpr SafeUnsigned& operator++() {
-			zAssert(MAX_VALUE - m_value > 0);
+			check([&] { return MAX_VALUE - m_value > 0; });
 			++m_value;
 			return *this;
 		}
 		constexpr SafeUnsigned& operator--() {
-			zAssert(m_value > 0);
+			check([&] { return m_value > 0; });
 			--m_value;
 			return *this;
 		}
 		constexpr SafeUnsigned& operator+=(const SafeUnsigned& t) {
-			zAssert(MAX_VALUE - m_value >= t.m_value);
+			check([&] { return MAX_VALUE - m_value >= t.m_value; });
 			m_value += t.m_value;
 			return *this;
 		}
 		constexpr SafeUnsigned& operator-=(const SafeUnsigned& t) {
-			zAssert(m_value >= t.m_value);
+			check([&] { return m_value >= t.m_value; });
 			m_value -= t.m_value;
 			return *this;
 		}
 		constexpr SafeUnsigned& operator*=(const SafeUnsigned& t) {
 			if (m_value != 0) {
-				zAssert(MAX_VALUE / m_value >= t.m_value);
+				check([&] { return MAX_VALUE / m_value >= t.m_value; });
 			}
 			m_value *= t.m_value;
 			return *this;
 		}
 		constexpr SafeUnsigned& operator/=(const SafeUnsigned& t) {
-			zAssert(t.m_value != 0);
+			check([&] { return t.m_value != 0; });
 			m_value /= t.m_value;
 			return *this;
 		}
@@ -74,12 +84,12 @@ namespace chess {
 
 		template<std::integral U>
 		constexpr SafeUnsigned operator<<(U s) const {
-			zAssert(std::cmp_less(s, sizeof(T) * 8));
+			check([&] { return std::cmp_less(s, sizeof(T) * 8); });
 			return SafeUnsigned{ static_cast<T>(m_value << s) };
 		}
 		template<std::integral U>
 		constexpr SafeUnsigned operator>>(U s) const {
-			zAssert(std::cmp_less(s, sizeof(T) * 8));
+			check([&] { return std::cmp_less(s, sizeof(T) * 8); });
 			return SafeUnsigned{ static_cast<T>(m_value >> s) };
 		}
 
@@ -88,7 +98,7 @@ namespace chess {
 		}
 
 		void subToMin(SafeUnsigned subbed, SafeUnsigned min) {
-			zAssert(min <= *this);
+			check([&] { return min <= *this; });
 
 			if (m_value < subbed.m_value) {
 				m_value = min.get();
@@ -99,21 +109,21 @@ namespace chess {
 		}
 
 		constexpr friend SafeUnsigned operator+(SafeUnsigned a, SafeUnsigned b) {
-			zAssert(MAX_VALUE - a.m_value >= b.m_value);
+			check([&] { return MAX_VALUE - a.m_value >= b.m_value; });
 			return SafeUnsigned{ static_cast<T>(a.m_value + b.m_value) }; //cast to stop integer promotion from kicking in
 		}
 		constexpr friend SafeUnsigned operator-(SafeUnsigned a, SafeUnsigned b) {
-			zAssert(a.m_value >= b.m_value);
+			check([&] { return a.m_value >= b.m_value; });
 			return SafeUnsigned{ static_cast<T>(a.m_value - b.m_value) }; 
 		}
 		constexpr friend SafeUnsigned operator*(SafeUnsigned a, SafeUnsigned b) {
 			if (a.m_value != 0) {
-				zAssert(MAX_VALUE / a.m_value >= b.m_value);
+				check([&] { return MAX_VALUE / a.m_value >= b.m_value; });
 			}
 			return SafeUnsigned{ static_cast<T>(a.m_value * b.m_value) }; 
 		}
 		constexpr friend SafeUnsigned operator/(SafeUnsigned a, SafeUnsigned b) {
-			zAssert(b.m_value != 0);
+			check([&] { return b.m_value != 0; });
 			return SafeUnsigned{ static_cast<T>(a.m_value / b.m_value) };
 		}
 		constexpr friend SafeUnsigned operator&(SafeUnsigned a, SafeUnsigned b) {
@@ -123,7 +133,7 @@ namespace chess {
 			return SafeUnsigned{ static_cast<T>(a.m_value | b.m_value) };
 		}
 		constexpr friend SafeUnsigned operator%(SafeUnsigned a, SafeUnsigned b) {
-			zAssert(b.m_value != 0);
+			check([&] { return b.m_value != 0; });
 			return SafeUnsigned{ static_cast<T>(a.m_value % b.m_value) };
 		}
 	};
@@ -0,0 +1,304 @@
+module Chess.SelfPlay;
+
+import nlohmann.json;
+import BS.thread_pool;
+
+import Chess.Arena;
+import Chess.EPD;
+import Chess.MoveGeneration;
+import Chess.Position.RepetitionMap;
+
+namespace chess {
+	double eloFromScore(double score) {
+		score = std::clamp(score, 1e-6, 1.0 - 1e-6);
+		return -400.0 * std::log10(1.0 / score - 1.0);
+	}
+
+	double scoreFromElo(double elo) {
+		return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+	}
+
+	double MatchStats::score() const {
+		if (gameCount() == 0) {
+			return 0.5;
+		}
+		return (static_cast<double>(wins) + static_cast<double>(draws) / 2.0) / static_cast<double>(gameCount());
+	}
+
+	//per game variance of the score
+	double scoreVariance(const MatchStats& stats) {
+		auto n = static_cast<double>(stats.gameCount());
+		auto w = static_cast<double>(stats.wins) / n;
+		auto d = static_cast<double>(stats.draws) / n;
+		auto s = stats.score();
+		return w + d / 4.0 - s * s;
+	}
+
+	double MatchStats::elo() const {
+		return eloFromScore(score());
+	}
+
+	double MatchStats::eloMargin() const {
+		if (gameCount() == 0) {
+			return 0.0;
+		}
+		constexpr auto Z_95 = 1.959964;
+		auto deviation = Z_95 * std::sqrt(scoreVariance(*this) / static_cast<double>(gameCount()));
+		return (eloFromScore(score() + deviation) - eloFromScore(score() - deviation)) / 2.0;
+	}
+
+	//generalized SPRT, approximating the trinomial outcome by a normal distribution of the score
+	double MatchStats::llr(double elo0, double elo1) const {
+		if (gameCount() == 0) {
+			return 0.0;
+		}
+		auto variance = scoreVariance(*this);
+		if (variance <= 0.0) {
+			return 0.0;
+		}
+		auto s0 = scoreFromElo(elo0);
+		auto s1 = scoreFromElo(elo1);
+		return (s1 - s0) * (2.0 * score() - s0 - s1) / (2.0 * variance / static_cast<double>(gameCount()));
+	}
+
+	EngineConfig loadEngineConfig(const std::filesystem::path& path) {
+		std::ifstream file{ path };
+		if (!file.is_open()) {
+			std::println("Error: could not open engine config {}", path.string());
+			std::exit(-1);
+		}
+		auto j = nlohmann::json::parse(file);
+
+		EngineConfig ret;
+		ret.name = j.value("name", path.stem().string());
+		if (j.contains("depth")) {
+			auto depth = j["depth"].get<std::uint64_t>(); //read wide, so that out of range depths are rejected instead of wrapping
+			if (depth < 1 || depth > MAX_SEARCH_DEPTH.get()) {
+				std::println("Error: depth in {} must be between 1 and {}", path.string(), static_cast<std::uint32_t>(MAX_SEARCH_DEPTH.get()));
+				std::exit(-1);
+			}
+			ret.limits.depth = SafeUnsigned{ static_cast<std::uint8_t>(depth) };
+		}
+		if (j.contains("nodes")) {
+			ret.limits.nodes = j["nodes"].get<std::uint64_t>();
+		}
+		if (j.contains("movetime_ms")) {
+			ret.limits.moveTime = std::chrono::milliseconds{ j["movetime_ms"].get<std::int64_t>() };
+		}
+		if (j.contains("parameters")) {
+			for (const auto& [name, value] : j["parameters"].items()) {
+				auto parameter = findTunableParameter(name);
+				if (!parameter) {
+					std::println("Error: unknown search parameter {} in {}", name, path.string());
+					std::exit(-1);
+				}
+				parameter->apply(ret.parameters, value.get<double>());
+			}
+		}
+		return ret;
+	}
+
+	void saveEngineConfig(const EngineConfig& config, const std::filesystem::path& path) {
+		nlohmann::json j;
+		j["name"] = config.name;
+		j["depth"] = config.limits.depth.get();
+		if (config.limits.nodes) {
+			j["nodes"] = *config.limits.nodes;
+		}
+		if (config.limits.moveTime) {
+			j["movetime_ms"] = config.limits.moveTime->count();
+		}
+		for (const auto& parameter : getTunableParameters()) {
+			j["parameters"][parameter.name] = parameter.get(config.parameters);
+		}
+
+		std::ofstream file{ path };
+		if (!file.is_open()) {
+			std::println("Error: could not write engine config {}", path.string());
+			return;
+		}
+		file << j.dump(4) << '\n';
+	}
+
+	enum class GameResult {
+		WhiteWins,
+		Draw,
+		BlackWins
+	};
+
+	bool onlyKingsLeft(const Position& pos) {
+		return pos.pieceCount() == 2;
+	}
+
+	class Adjudicator {
+	private:
+		const SelfPlayOptions& m_options;
+		int m_whiteWinningPlies = 0;
+		int m_blackWinningPlies = 0;
+	public:
+		Adjudicator(const SelfPlayOptions& options) : m_options{ options } {}
+
+		//ratings are from white's perspective, so both engines agree when consecutive ratings have the same sign
+		std::optional<GameResult> update(Rating rating) {
+			m_whiteWinningPlies = rating >= m_options.adjudicationRating ? m_whiteWinningPlies + 1 : 0;
+			m_blackWinningPlies = rating <= -m_options.adjudicationRating ? m_blackWinningPlies + 1 : 0;
+			if (m_whiteWinningPlies >= m_options.adjudicationPlies) {
+				return GameResult::WhiteWins;
+			} else if (m_blackWinningPlies >= m_options.adjudicationPlies) {
+				return GameResult::BlackWins;
+			}
+			return std::nullopt;
+		}
+	};
+
+	GameResult playGame(IsolatedSearch& white, const SearchLimits& whiteLimits, IsolatedSearch& black, const SearchLimits& blackLimits,
+		const Position& opening, const SelfPlayOptions& options)
+	{
+		white.clearPositionTable();
+		black.clearPositionTable();
+
+		auto pos = opening;
+		RepetitionMap repetitionMap;
+		repetitionMap.push(pos);
+		Adjudicator adjudicator{ options };
+
+		for (int ply = 0; ply < options.maxPlies; ply++) {
+			if (repetitionMap.getPositionCount(pos) >= 3 || onlyKingsLeft(pos)) {
+				return GameResult::Draw;
+			}
+
+			auto result = pos.isWhite() ? white.search(pos, repetitionMap, whiteLimits) : black.search(pos, repetitionMap, blackLimits);
+			if (!result.bestMove) {
+				if (calcPositionData(pos).isCheckmate()) {
+					return pos.isWhite() ? GameResult::BlackWins : GameResult::WhiteWins;
+				}
+				return GameResult::Draw; //stalemate
+			}
+			if (auto adjudication = adjudicator.update(result.rating)) {
+				return *adjudication;
+			}
+
+			pos.move(*result.bestMove);
+			repetitionMap.push(pos);
+		}
+		return GameResult::Draw;
+	}
+
+	struct EnginePair {
+		IsolatedSearch first;
+		IsolatedSearch second;
+	};
+
+	struct SelfPlayRunnerState {
+		static constexpr auto TABLE_SIZE = 1uz << 18;
+
+		BS::thread_pool<> pool{ std::thread::hardware_concurrency() };
+		std::vector<EnginePair> engines; //one pair per pool thread
+
+		SelfPlayRunnerState() {
+			for (auto threadID : pool.get_thread_ids()) {
+				arena::registerThread(threadID);
+			}
+			for (auto i = 0uz; i < pool.get_thread_count(); i++) {
+				engines.emplace_back(IsolatedSearch{ TABLE_SIZE }, IsolatedSearch{ TABLE_SIZE });
+			}
+		}
+	};
+
+	SelfPlayRunner::SelfPlayRunner()
+		: m_state{ std::make_shared<SelfPlayRunnerState>() }
+	{
+	}
+
+	struct SPRTBounds {
+		double lower = 0.0;
+		double upper = 0.0;
+	};
+
+	SPRTBounds calcSPRTBounds(const SelfPlayOptions& options) {
+		return { std::log(options.beta / (1.0 - options.alpha)), std::log((1.0 - options.beta) / options.alpha) };
+	}
+
+	void printProgress(const MatchStats& stats, const SelfPlayOptions& options) {
+		auto [lowerBound, upperBound] = calcSPRTBounds(options);
+		std::println("Games: {} | +{} ={} -{} | Elo: {:.1f} +/- {:.1f} | LLR: {:.2f} [{:.2f}, {:.2f}]",
+			stats.gameCount(), stats.wins, stats.draws, stats.losses, stats.elo(), stats.eloMargin(),
+			stats.llr(options.elo0, options.elo1), lowerBound, upperBound);
+	}
+
+	MatchStats SelfPlayRunner::play(const SelfPlayOptions& options, std::span<const Position> openings) {
+		if (openings.empty()) {
+			std::println("Error: no openings to play");
+			return {};
+		}
+
+		auto& [pool, engines] = *m_state;
+		for (auto& [first, second] : engines) {
+			first.setParameters(options.first.parameters);
+			second.setParameters(options.second.parameters);
+		}
+
+		auto [lowerBound, upperBound] = calcSPRTBounds(options);
+
+		std::mutex statsMutex;
+		MatchStats stats;
+		std::atomic_bool finished = false;
+
+		//every opening is played twice, with the engines swapping colors
+		pool.detach_sequence(0uz, options.gameCount, [&](size_t game) {
+			if (finished.load()) {
+				return;
+			}
+			auto& [first, second] = engines[*BS::this_thread::get_index()];
+			const auto& opening = openings[(game / 2) % openings.size()];
+			auto firstIsWhite = (game % 2 == 0);
+
+			auto result = firstIsWhite ? playGame(first, options.first.limits, second, options.second.limits, opening, options) :
+										 playGame(second, options.second.limits, first, options.first.limits, opening, options);
+
+			std::scoped_lock l{ statsMutex };
+			if (result == GameResult::Draw) {
+				stats.draws++;
+			} else if ((result == GameResult::WhiteWins) == firstIsWhite) {
+				stats.wins++;
+			} else {
+				stats.losses++;
+			}
+			if (options.printProgress) {
+				printProgress(stats, options);
+			}
+
+			auto llr = stats.llr(options.elo0, options.elo1);
+			if (options.stopOnSPRT && (llr <= lowerBound || llr >= upperBound)) {
+				finished.store(true);
+			}
+		});
+		pool.wait();
+		return stats;
+	}
+
+	MatchStats runSelfPlay(const SelfPlayOptions& options) {
+		auto openings = loadEPDFile(options.openingsPath);
+		if (openings.empty()) {
+			std::println("Error: no openings in {}", options.openingsPath.string());
+			return {};
+		}
+		auto positions = openings | std::views::transform(&EPDEntry::pos) | std::ranges::to<std::vector>();
+
+		SelfPlayRunner runner;
+		auto stats = runner.play(options, positions);
+
+		if (options.printProgress) {
+			auto [lowerBound, upperBound] = calcSPRTBounds(options);
+			auto llr = stats.llr(options.elo0, options.elo1);
+			if (llr >= upperBound) {
+				std::println("H1 accepted: {} is stronger than {}", options.first.name, options.second.name);
+			} else if (llr <= lowerBound) {
+				std::println("H0 accepted: {} is not stronger than {}", options.first.name, options.second.name);
+			} else {
+				std::println("SPRT inconclusive after {} games", stats.gameCount());
+			}
+		}
+		return stats;
+	}
+}
@@ -0,0 +1,66 @@
+export module Chess.SelfPlay;
+
+import std;
+
+export import Chess.MoveSearch;
+export import Chess.Position;
+export import Chess.Rating;
+
+namespace chess {
+	struct SelfPlayRunnerState;
+}
+
+export namespace chess {
+	struct EngineConfig {
+		std::string name;
+		SearchLimits limits;
+		SearchParameters parameters;
+	};
+
+	struct SelfPlayOptions {
+		std::filesystem::path openingsPath;
+		size_t gameCount = 0;
+		EngineConfig first;
+		EngineConfig second;
+		Rating adjudicationRating = 10_rt; //a game is adjudicated once both engines agree on a score at least this large...
+		int adjudicationPlies = 8;         //...for this many plies in a row
+		int maxPlies = 400;                //games that reach this many plies are drawn
+		double elo0 = 0.0;
+		double elo1 = 5.0;
+		double alpha = 0.05;
+		double beta = 0.05;
+		bool stopOnSPRT = true;            //when false, every game is played even after the SPRT has concluded
+		bool printProgress = true;
+	};
+
+	//wins, draws and losses are from the first engine's point of view
+	struct MatchStats {
+		size_t wins = 0;
+		size_t draws = 0;
+		size_t losses = 0;
+
+		size_t gameCount() const {
+			return wins + draws + losses;
+		}
+		double score() const;
+		double elo() const;
+		double eloMargin() const; //95% confidence
+		double llr(double elo0, double elo1) const;
+	};
+
+	//engines are searched across every hardware thread. The threads are kept between matches, so that repeated matches
+	//don't register new threads with the arena each time.
+	class SelfPlayRunner {
+	private:
+		std::shared_ptr<SelfPlayRunnerState> m_state;
+	public:
+		SelfPlayRunner();
+
+		//options.openingsPath is ignored in favor of openings
+		MatchStats play(const SelfPlayOptions& options, std::span<const Position> openings);
+	};
+
+	EngineConfig loadEngineConfig(const std::filesystem::path& path);
+	void saveEngineConfig(const EngineConfig& config, const std::filesystem::path& path);
+	MatchStats runSelfPlay(const SelfPlayOptions& options);
+}
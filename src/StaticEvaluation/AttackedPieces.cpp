@@ -0,0 +1,20 @@
+module Chess.Evaluation:AttackedPieces;
+
+import Chess.Position.PieceState;
+
+import :Constants;
+
+namespace chess {
+	Rating calcAttackRating(const Position& pos, const PositionData& posData) {
+		auto [white, black] = pos.getColorSides();
+		
+		auto getAttackedPiecesRating = [&](const PieceState& pieceState, Bitboard enemySquares) -> Rating {
+			auto attackedPieces = pieceState.calcAllLocations() & enemySquares;
+			auto attackedPieceCount = std::popcount(attackedPieces);
+			return static_cast<Rating>(attackedPieceCount) * ATTACKED_PIECE_RATING;
+		};
+		auto allWhiteSquares = posData.whiteSquares.destSquaresPinConsidered;
+		auto allBlackSquares = posData.blackSquares.destSquaresPinConsidered;
+		return getAttackedPiecesRating(white, allBlackSquares) - getAttackedPiecesRating(black, allWhiteSquares);
+	}
+}
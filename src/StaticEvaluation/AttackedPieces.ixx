@@ -0,0 +1,8 @@
+export module Chess.Evaluation:AttackedPieces;
+
+export import Chess.Position;
+export import Chess.Rating;
+
+namespace chess {
+	Rating calcAttackRating(const Position& pos, const PositionData& posData);
+}
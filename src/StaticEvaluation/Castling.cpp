@@ -0,0 +1,14 @@
+module Chess.Evaluation:Castling;
+
+import :Constants;
+
+namespace chess {
+	Rating calcCastleRating(const Position& pos) {
+		auto [white, black] = pos.getColorSides();
+
+		auto getCastleRating = [](const auto& pieceState) {
+			return pieceState.castling.hasCastledKingside() || pieceState.castling.hasCastledQueenside() ? CASTLE_RATING : 0_rt;
+		};
+		return getCastleRating(white) - getCastleRating(black);
+	}
+}
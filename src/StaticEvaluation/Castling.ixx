@@ -0,0 +1,8 @@
+export module Chess.Evaluation:Castling;
+
+export import Chess.Position;
+export import Chess.Rating;
+
+namespace chess {
+	Rating calcCastleRating(const Position& pos);
+}
@@ -0,0 +1,43 @@
+module Chess.Evaluation:InternalBenchmarks;
+
+import :AttackedPieces;
+import :Castling;
+import :KingSafety;
+import :Material;
+import :PawnStructure;
+import :PieceDevelopment;
+
+namespace chess {
+	namespace benchmarks {
+		template<typename Term>
+		void benchmarkPositionTerm(MicrobenchmarkRunner& runner, std::string_view name, std::span<const Position> corpus, Term term) {
+			runner.run(name, [&] {
+				auto total = 0_rt;
+				for (const auto& pos : corpus) {
+					total += term(pos);
+				}
+				doNotOptimize(&total);
+			});
+		}
+
+		template<typename Term>
+		void benchmarkPositionDataTerm(MicrobenchmarkRunner& runner, std::string_view name, std::span<const Position> corpus, std::span<const PositionData* const> positionData, Term term) {
+			runner.run(name, [&] {
+				auto total = 0_rt;
+				for (auto [pos, posData] : std::views::zip(corpus, positionData)) {
+					total += term(pos, *posData);
+				}
+				doNotOptimize(&total);
+			});
+		}
+
+		void runInternalEvaluationBenchmarks(MicrobenchmarkRunner& runner, std::span<const Position> corpus, std::span<const PositionData* const> positionData) {
+			benchmarkPositionTerm(runner, "calcMaterialRating", corpus, calcMaterialRating);
+			benchmarkPositionTerm(runner, "calcPawnStructureRating", corpus, calcPawnStructureRating);
+			benchmarkPositionTerm(runner, "calcCastleRating", corpus, calcCastleRating);
+			benchmarkPositionDataTerm(runner, "calcAttackRating", corpus, positionData, calcAttackRating);
+			benchmarkPositionDataTerm(runner, "calcKingSafetyRating", corpus, positionData, calcKingSafetyRating);
+			benchmarkPositionDataTerm(runner, "calcPieceDevelopmentRating", corpus, positionData, calcPieceDevelopmentRating);
+		}
+	}
+}
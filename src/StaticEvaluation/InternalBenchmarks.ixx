@@ -0,0 +1,12 @@
+export module Chess.Evaluation:InternalBenchmarks;
+
+export import std;
+export import Chess.Benchmark;
+export import Chess.Position;
+
+export namespace chess {
+	namespace benchmarks {
+		//positionData[i] must be calculated from corpus[i]
+		void runInternalEvaluationBenchmarks(MicrobenchmarkRunner& runner, std::span<const Position> corpus, std::span<const PositionData* const> positionData);
+	}
+}
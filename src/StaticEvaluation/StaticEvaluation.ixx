@@ -2,6 +2,7 @@ export module Chess.Evaluation;
 
 import Chess.Position;
 export import Chess.Rating;
+export import :InternalBenchmarks;
 export import :InternalTests;
 
 export namespace chess {
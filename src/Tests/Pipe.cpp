@@ -2,6 +2,13 @@ module;
 
 #ifdef _WIN64
 #include <Windows.h>
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #endif
 
 module Chess.Tests:Pipe;
@@ -10,9 +17,10 @@ namespace chess {
 	constexpr size_t READ_BUFF_MAX_SIZE = 8196;
 	using ReadBuffer = std::array<char, READ_BUFF_MAX_SIZE>;
 
+	//returns std::nullopt if the read timed out
 	template<typename T>
 	concept Reader = std::invocable<T, ReadBuffer&> && 
-					 std::same_as<std::invoke_result_t<T, ReadBuffer&>, std::string_view>;
+					 std::same_as<std::invoke_result_t<T, ReadBuffer&>, std::optional<std::string_view>>;
 
 	class LineParseBuffer {
 	private:
@@ -24,31 +32,42 @@ namespace chess {
 			std::ranges::fill(m_readBuff, '\0');
 		}
 	private:
+		//returns std::nullopt if the reader timed out first
 		template<Reader Reader, typename Substr, std::invocable GetSearchableText>
-		size_t readUntil(Reader childReader, Substr substr, GetSearchableText getSearchableText) {
+		std::optional<size_t> readUntil(Reader childReader, Substr substr, GetSearchableText getSearchableText) {
 			while (true) {
 				auto searchableText = getSearchableText();
 				auto substrIndex = searchableText.find(substr);
-				if (substrIndex == std::string_view::npos) {
-					m_cumulativeBuff.append(childReader(m_readBuff));
-				} else {
+				if (substrIndex != std::string_view::npos) {
 					return substrIndex;
 				}
+				auto text = childReader(m_readBuff);
+				if (!text) {
+					return std::nullopt;
+				}
+				m_cumulativeBuff.append(*text);
 			}
 			std::unreachable();
 		}
 	public:
+		//text read before a timeout is kept, so a late line can still be found by the next call
 		template<Reader Reader>
-		std::string parse(std::string_view lineBegin, Reader childReader) {
+		std::optional<std::string> parse(std::string_view lineBegin, Reader childReader) {
 			auto relativeLineBeginIndex = readUntil(childReader, lineBegin, [this] {
 				return std::string_view{ m_cumulativeBuff.data() + m_offset, m_cumulativeBuff.size() - m_offset };
 			});
-			auto absLineBeginIndex = m_offset + relativeLineBeginIndex;
+			if (!relativeLineBeginIndex) {
+				return std::nullopt;
+			}
+			auto absLineBeginIndex = m_offset + *relativeLineBeginIndex;
 			auto absAfterLineBeginIndex = absLineBeginIndex + lineBegin.size();
 			auto relativeNewlineIndex = readUntil(childReader, '\n', [&, this] {
 				return std::string_view{ m_cumulativeBuff.data() + absAfterLineBeginIndex };
 			});
-			auto absNewlineIndex = absAfterLineBeginIndex + relativeNewlineIndex;
+			if (!relativeNewlineIndex) {
+				return std::nullopt;
+			}
+			auto absNewlineIndex = absAfterLineBeginIndex + *relativeNewlineIndex;
 
 			m_offset = absNewlineIndex;
 
@@ -95,7 +114,7 @@ namespace chess {
 			return { enginePath, engineDir };
 		}
 	public:
-		WindowsPipe() {
+		explicit WindowsPipe(std::span<const std::string> args) {
 			ZeroMemory(&m_pi, sizeof(m_pi));
 			
 			SECURITY_ATTRIBUTES sa = { sizeof(sa), nullptr, true };
@@ -118,7 +137,12 @@ namespace chess {
 
 			auto [path, dir] = getProcessData();
 
-			auto res = CreateProcessA(path.c_str(), nullptr, nullptr, nullptr, true, CREATE_NEW_CONSOLE, nullptr,
+			auto commandLine = std::format("\"{}\"", path);
+			for (const auto& arg : args) {
+				commandLine += std::format(" {}", arg);
+			}
+
+			auto res = CreateProcessA(path.c_str(), commandLine.data(), nullptr, nullptr, true, CREATE_NEW_CONSOLE, nullptr,
 				dir.c_str(), &si, &m_pi);
 			if (!res) {
 				std::println("Error: could not start separate process: {}", GetLastError());
@@ -144,7 +168,19 @@ namespace chess {
 			}
 		}
 	private:
-		std::string_view readFromChild(ReadBuffer& readBuff) {
+		std::optional<std::string_view> readFromChild(ReadBuffer& readBuff, std::optional<std::chrono::steady_clock::time_point> deadline) {
+			//anonymous pipes can't be waited on with a timeout, so poll until there is something to read
+			while (deadline) {
+				DWORD bytesAvailable = 0;
+				if (PeekNamedPipe(m_stdoutR, nullptr, 0, nullptr, &bytesAvailable, nullptr) && bytesAvailable > 0) {
+					break;
+				}
+				if (std::chrono::steady_clock::now() >= *deadline) {
+					return std::nullopt;
+				}
+				Sleep(1);
+			}
+
 			DWORD dwRead = 0;
 			auto readRes = ReadFile(m_stdoutR, readBuff.data(), sizeof(readBuff) - 1, &dwRead, nullptr);
 			if (!readRes) {
@@ -155,9 +191,10 @@ namespace chess {
 			return std::string_view{ readBuff.data(), std::strlen(readBuff.data()) };
 		}
 	public:
-		std::string read(std::string_view lineBegin) override {
-			return m_lineParseBuff.parse(lineBegin, [this](auto& readBuff) {
-				return readFromChild(readBuff);
+		std::optional<std::string> read(std::string_view lineBegin, std::optional<std::chrono::milliseconds> timeout) override {
+			auto deadline = timeout.transform([](auto t) { return std::chrono::steady_clock::now() + t; });
+			return m_lineParseBuff.parse(lineBegin, [this, deadline](auto& readBuff) {
+				return readFromChild(readBuff, deadline);
 			});
 		}
 
@@ -177,11 +214,136 @@ namespace chess {
 		}
 	};
 	using PipeInheritor = WindowsPipe;
+#elif defined(__linux__)
+	class PosixPipe : public OSPipe {
+	private:
+		pid_t m_pid = -1;
+		int m_stdinW = -1;
+		int m_stdoutR = -1;
+		LineParseBuffer m_lineParseBuff;
+
+		static void closeDescriptor(int& fd) {
+			if (fd >= 0) {
+				close(fd);
+				fd = -1;
+			}
+		}
+
+		static std::array<int, 2> createPipe() {
+			std::array<int, 2> fds;
+			if (pipe2(fds.data(), O_CLOEXEC) != 0) { //the child only keeps the ends that are duplicated onto stdin and stdout
+				std::println("Error: could not create pipe: {}", std::strerror(errno));
+				std::exit(-1);
+			}
+			return fds;
+		}
+	public:
+		explicit PosixPipe(std::span<const std::string> args) {
+			std::signal(SIGPIPE, SIG_IGN); //report writes to a dead child as errors instead of being killed
+
+			auto [stdinR, stdinW] = createPipe();
+			auto [stdoutR, stdoutW] = createPipe();
+
+			auto path = std::filesystem::read_symlink("/proc/self/exe");
+			auto dir = path.parent_path();
+
+			posix_spawn_file_actions_t actions;
+			posix_spawn_file_actions_init(&actions);
+			posix_spawn_file_actions_adddup2(&actions, stdinR, STDIN_FILENO);
+			posix_spawn_file_actions_adddup2(&actions, stdoutW, STDOUT_FILENO);
+			posix_spawn_file_actions_adddup2(&actions, stdoutW, STDERR_FILENO);
+			posix_spawn_file_actions_addchdir_np(&actions, dir.c_str());
+
+			auto pathStr = path.string();
+			std::vector<char*> argv{ pathStr.data() };
+			std::vector<std::string> argsCopy{ args.begin(), args.end() }; //posix_spawn takes non-const strings
+			for (auto& arg : argsCopy) {
+				argv.push_back(arg.data());
+			}
+			argv.push_back(nullptr);
+
+			auto res = posix_spawn(&m_pid, pathStr.c_str(), &actions, nullptr, argv.data(), environ);
+			posix_spawn_file_actions_destroy(&actions);
+			if (res != 0) {
+				std::println("Error: could not start separate process: {}", std::strerror(res));
+				std::exit(-1);
+			}
+
+			//destroy descriptors not used by the parent
+			closeDescriptor(stdinR);
+			closeDescriptor(stdoutW);
+			m_stdinW = stdinW;
+			m_stdoutR = stdoutR;
+		}
+
+		void write(std::string_view command) override {
+			auto totalBytesWritten = 0uz;
+			while (totalBytesWritten < command.size()) {
+				auto bytesWritten = ::write(m_stdinW, command.data() + totalBytesWritten, command.size() - totalBytesWritten);
+				if (bytesWritten < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					std::println("Failed to write {}: {}", command, std::strerror(errno));
+					std::exit(-1);
+				}
+				totalBytesWritten += static_cast<size_t>(bytesWritten);
+			}
+		}
+	private:
+		std::optional<std::string_view> readFromChild(ReadBuffer& readBuff, std::optional<std::chrono::steady_clock::time_point> deadline) {
+			while (deadline) {
+				auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now());
+				if (remaining.count() <= 0) {
+					return std::nullopt;
+				}
+				pollfd pfd{ m_stdoutR, POLLIN, 0 };
+				auto ready = poll(&pfd, 1, static_cast<int>(remaining.count()));
+				if (ready > 0) {
+					break;
+				}
+				if (ready < 0 && errno != EINTR) {
+					std::println("Error: could not wait for the child process: {}", std::strerror(errno));
+					std::exit(-1);
+				}
+			}
+
+			ssize_t bytesRead = 0;
+			do {
+				bytesRead = ::read(m_stdoutR, readBuff.data(), readBuff.size() - 1);
+			} while (bytesRead < 0 && errno == EINTR);
+			if (bytesRead <= 0) {
+				std::println("Error: child process stopped writing data: {}", bytesRead == 0 ? "end of file" : std::strerror(errno));
+				std::exit(-1);
+			}
+			readBuff[static_cast<size_t>(bytesRead)] = '\0';
+			return std::string_view{ readBuff.data(), std::strlen(readBuff.data()) };
+		}
+	public:
+		std::optional<std::string> read(std::string_view lineBegin, std::optional<std::chrono::milliseconds> timeout) override {
+			auto deadline = timeout.transform([](auto t) { return std::chrono::steady_clock::now() + t; });
+			return m_lineParseBuff.parse(lineBegin, [this, deadline](auto& readBuff) {
+				return readFromChild(readBuff, deadline);
+			});
+		}
+
+		~PosixPipe() override {
+			closeDescriptor(m_stdinW);
+			closeDescriptor(m_stdoutR);
+			if (m_pid > 0) { //kill child process
+				if (kill(m_pid, SIGKILL) != 0) {
+					std::println("Error: failed to destroy child process: {}", std::strerror(errno));
+				}
+				waitpid(m_pid, nullptr, 0);
+			}
+		}
+	};
+	using PipeInheritor = PosixPipe;
 #else
-	static_assert("No pipe implemented for non-windows OS yet!")
+#error "No pipe implemented for this OS yet!"
 #endif
 
-	Pipe::Pipe() : m_osPipe{ std::make_unique<PipeInheritor>() }
+	Pipe::Pipe(std::span<const std::string> args) : m_osPipe{ std::make_unique<PipeInheritor>(args) }
 	{
 	}
 
@@ -194,6 +356,10 @@ namespace chess {
 	}
 
 	std::string Pipe::read(std::string_view expectedBegin) const {
-		return m_osPipe->read(expectedBegin);
+		return *m_osPipe->read(expectedBegin, std::nullopt);
+	}
+
+	std::optional<std::string> Pipe::tryRead(std::string_view expectedBegin, std::chrono::milliseconds timeout) const {
+		return m_osPipe->read(expectedBegin, timeout);
 	}
 }
\ No newline at end of file
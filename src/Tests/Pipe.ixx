@@ -5,17 +5,20 @@ import std;
 namespace chess {
 	struct OSPipe {
 		virtual void write(std::string_view command) = 0;
-		virtual std::string read(std::string_view expectedBegin) = 0;
+		//waits forever if timeout is std::nullopt, otherwise returns std::nullopt once it passes
+		virtual std::optional<std::string> read(std::string_view expectedBegin, std::optional<std::chrono::milliseconds> timeout) = 0;
 		virtual ~OSPipe() {}
 	};
 
+	//runs this executable as a child process with the given arguments, connected to its stdin and stdout
 	export class Pipe {
 	private:
 		std::unique_ptr<OSPipe> m_osPipe = nullptr;
 	public:
-		Pipe();
+		explicit Pipe(std::span<const std::string> args = {});
 		
 		void write(std::string_view command) const;
 		std::string read(std::string_view expectedBegin) const;
+		std::optional<std::string> tryRead(std::string_view expectedBegin, std::chrono::milliseconds timeout) const;
 	};
-}
\ No newline at end of file
+}
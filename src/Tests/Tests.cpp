@@ -2,6 +2,8 @@ module;
 
 #include <magic_enum/magic_enum.hpp>
 
+#include "../CAPI/agent_smith.h"
+
 #define assert_equality(value, expected) \
 	{ \
 		auto getPrintableValue = [&](auto a) { \
@@ -32,13 +34,21 @@ import std;
 
 import Chess.Arena;
 import Chess.BitboardImage;
+import Chess.Engine;
+import Chess.EPD;
+import Chess.PGN;
 import Chess.Evaluation;
 import Chess.Position;
 import Chess.PositionCommand;
 import Chess.MoveGeneration;
 import Chess.MoveSearch;
+import Chess.OpeningBook;
+import Chess.PackedPosition;
 import Chess.Position.RepetitionMap;
 import Chess.SafeInt;
+import Chess.SAN;
+import Chess.SelfPlay;
+import Chess.ThreadAffinity;
 
 import :Pipe;
 
@@ -478,6 +488,375 @@ namespace chess {
 			assert_equality(bestMove->to, Square::G2);
 		}
 
+		void testEPDParsing() {
+			auto entry = parseEPDLine("r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - bm Qxf7#; am Nc3; id \"scholar's mate\";");
+			if (!entry) {
+				std::println("testEPDParsing failed: could not parse EPD line");
+				return;
+			}
+			assert_equality(entry->id, "scholar's mate");
+			assert_equality(entry->bestMoves.size(), 1uz);
+			assert_equality(entry->avoidMoves.size(), 1uz);
+
+			auto posData = calcPositionData(entry->pos);
+			auto bestMove = parseSANMove(entry->bestMoves[0], posData.legalMoves);
+			if (!bestMove) {
+				std::println("testEPDParsing failed: could not resolve {}", entry->bestMoves[0]);
+				return;
+			}
+			assert_equality(bestMove->from, Square::H5);
+			assert_equality(bestMove->to, Square::F7);
+			assert_equality(bestMove->capturedPiece, Pawn);
+		}
+
+		void testSANDisambiguation() {
+			Position pos;
+			pos.setPos(parsePositionCommand("fen 4k3/8/8/8/8/8/4K3/R6R w - - 0 1"));
+			auto posData = calcPositionData(pos);
+
+			auto rookMove = parseSANMove("Rad1", posData.legalMoves);
+			assert_equality(rookMove.has_value(), true);
+			assert_equality(rookMove->from, Square::A1);
+
+			auto ambiguousMove = parseSANMove("Rd1", posData.legalMoves);
+			assert_equality(ambiguousMove.has_value(), false);
+
+			pos.setPos(parsePositionCommand("fen 4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1"));
+			auto castlePosData = calcPositionData(pos);
+			auto castle = parseSANMove("O-O", castlePosData.legalMoves);
+			assert_equality(castle.has_value(), true);
+			assert_equality(castle->to, Square::G1);
+		}
+
+		void testPGNReading() {
+			constexpr std::string_view PGN_TEXT =
+				"[Event \"Computer chess game\"]\n"
+				"[Result \"1-0\"]\n"
+				"\n"
+				"1. e4 {best by test} e5 2. Bc4 Nc6 (2... Nf6 3. d3) 3. Qh5 Nf6?? 4. Qxf7# 1-0\n"
+				"\n"
+				"[Event \"Computer chess game\"]\n"
+				"[Result \"*\"]\n"
+				"\n"
+				"1. e4 h5 2. Ba6 *\n"
+				"\n"
+				"[Event \"Computer chess game\"]\n"
+				"\n"
+				"1. d4 d5 0-1\n";
+
+			PGNStats stats;
+			std::vector<PGNPosition> positions;
+			for (const auto& pgnPosition : readPGNPositions(PGN_TEXT, stats)) {
+				positions.push_back(pgnPosition);
+			}
+
+			assert_equality(stats.gameCount, 3uz);
+			assert_equality(stats.unreadableGameCount, 0uz);
+			assert_equality(stats.positionCount, 15uz); //7 + 1, 3 + 1 and 2 + 1 plies and initial positions
+			assert_equality(positions.size(), 15uz);
+			assert_equality(positions[7].result, PGNResult::WhiteWins);
+			assert_equality(positions[11].result, PGNResult::Unknown);
+
+			//without a Result tag, every position takes its result from the termination marker
+			for (auto i = 12uz; i < positions.size(); i++) {
+				assert_equality(positions[i].result, PGNResult::BlackWins);
+			}
+			assert_equality(positions[14].ply, 2);
+
+			auto posData = calcPositionData(positions[7].pos);
+			assert_equality(posData.isCheckmate(), true);
+		}
+
+		void testPackedPositionRoundTrip() {
+			Position pos;
+			pos.setPos(parsePositionCommand("fen r3k2r/pp3ppp/8/3pP3/8/8/PPP2PPP/R3K2R w Kq d6 7 20"));
+			assert_equality(pos.halfmoveClock(), std::uint8_t{ 7 });
+
+			auto packed = pos.pack();
+			Position unpacked;
+			unpacked.setPos(packed);
+			assert_equality(unpacked.hash(), pos.hash());
+			assert_equality(unpacked.halfmoveClock(), pos.halfmoveClock());
+			assert_equality(unpacked.pack() == packed, true);
+
+			pos.move("e1g1");
+			assert_equality(pos.halfmoveClock(), std::uint8_t{ 8 });
+			pos.move("a7a6");
+			assert_equality(pos.halfmoveClock(), std::uint8_t{ 0 });
+
+			auto path = std::filesystem::temp_directory_path() / "chess_packed_positions.bin";
+			{
+				std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+				std::mutex fileMutex;
+				PackedPositionWriter writer{ file, fileMutex };
+				std::array positions{ packed, pos.pack(), packed };
+				writer.write(positions);
+				writer.flush();
+			}
+
+			std::vector<PackedPosition> readPositions;
+			for (auto batch : readPackedPositions(path, 2)) {
+				readPositions.insert(readPositions.end(), batch.begin(), batch.end());
+			}
+			std::filesystem::remove(path);
+
+			assert_equality(readPositions.size(), 3uz);
+			assert_equality(readPositions[1] == pos.pack(), true);
+		}
+
+		void testThreadPlacement() {
+			//4 cores with 2 SMT siblings each, numbered the way Linux usually numbers them
+			std::vector<LogicalProcessor> topology;
+			for (auto id = 0u; id < 8; id++) {
+				topology.push_back({ id, id % 4, 0 });
+			}
+
+			ThreadPlacement placement;
+			assert_equality(planThreadPlacement(placement, topology).searchProcessors.empty(), true);
+
+			placement.pinThreads = true;
+			placement.reservedIOCores = 1;
+			auto plan = planThreadPlacement(placement, topology);
+			assert_equality(plan.ioProcessors == std::vector<std::uint32_t>{ 0, 4 }, true);
+			assert_equality(plan.searchProcessors == std::vector<std::uint32_t>{ 1, 2, 3, 5, 6, 7 }, true);
+
+			placement.processors = *parseProcessorList("2-5");
+			plan = planThreadPlacement(placement, topology);
+			assert_equality(plan.searchProcessors == std::vector<std::uint32_t>{ 2, 3, 5 }, true);
+			assert_equality(parseProcessorList("1,3-").has_value(), false);
+			assert_equality(parseProcessorList("0-4294967295").has_value(), false);
+			assert_equality(parseProcessorList(std::format("0-{}", MAX_PROCESSOR_ID - 1))->size(), static_cast<size_t>(MAX_PROCESSOR_ID));
+		}
+
+		void testTurnDataSides() {
+			Position pos;
+			pos.setPos(parsePositionCommand("startpos moves e2e4"));
+
+			auto turnData = pos.getTurnData();
+			auto blackTurnData = pos.getTurnData<false>();
+			auto [white, black] = pos.getColorSides();
+			assert_equality(turnData.isWhite, false);
+			assert_equality(&turnData.allies, &black);
+			assert_equality(&blackTurnData.allies, &black);
+			assert_equality(&blackTurnData.enemies, &white);
+			assert_equality(blackTurnData.allyKingside.kingTo, Square::G8);
+			assert_equality(blackTurnData.enemyQueenside.kingTo, Square::C1);
+		}
+
+		void testFENRoundTrip() {
+			constexpr std::array FENS{
+				STARTING_FEN_STRING,
+				std::string_view{ "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1" },
+				std::string_view{ "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3" },
+				std::string_view{ "8/8/8/8/4Pp2/8/8/k6K b - e3 12 40" }
+			};
+			for (auto fen : FENS) {
+				Position pos;
+				assert_equality(pos.setFEN(fen).has_value(), true);
+				assert_equality(pos.toFEN(), std::string{ fen });
+
+				Position commandPos;
+				commandPos.setPos(parsePositionCommand(std::format("fen {}", fen)));
+				assert_equality(pos.hash(), commandPos.hash());
+			}
+
+			Position pos;
+			pos.setPos(parsePositionCommand("startpos moves e2e4 c7c5 g1f3"));
+			assert_equality(pos.toFEN(), std::string{ "rnbqkbnr/pp1ppppp/8/2p5/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2" });
+
+			auto expectError = [](std::string_view fen, FENError error) {
+				Position pos;
+				pos.setPos(parsePositionCommand("startpos"));
+				auto result = pos.setFEN(fen);
+				assert_equality(result.has_value(), false);
+				assert_equality(result.error(), error);
+				assert_equality(pos.toFEN(), std::string{ STARTING_FEN_STRING }); //left untouched
+			};
+			expectError("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq", FENError::MissingField);
+			expectError("rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -", FENError::InvalidBoard);
+			expectError("rnbqkbnr/pppppppp/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -", FENError::InvalidBoard);
+			expectError("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQQBNR w KQkq -", FENError::InvalidKingCount);
+			expectError("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq -", FENError::InvalidSideToMove);
+			expectError("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQxq -", FENError::InvalidCastling);
+			expectError("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e3", FENError::InvalidEnPassant);
+			expectError("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e6", FENError::InvalidEnPassant); //no pawn jumped to e5
+			expectError("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 300 1", FENError::InvalidHalfmoveClock);
+			expectError("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 0", FENError::InvalidFullmoveNumber);
+		}
+
+		void testSafeUnsignedProfiles() {
+			//the profiles differ only in whether contracts are checked, so in range arithmetic must agree
+			auto walk = []<bool Checked>(std::bool_constant<Checked>) {
+				using Depth = SafeUnsigned<std::uint8_t, Checked>;
+				Depth depth{ 7 };
+				depth -= Depth{ 2 };
+				depth.subToMin(Depth{ 9 }, Depth{ 1 });
+				return ((depth + Depth{ 4 }) * Depth{ 3 } / Depth{ 2 }).get();
+			};
+			assert_equality(walk(std::true_type{}), walk(std::false_type{}));
+			assert_equality(walk(std::true_type{}), std::uint8_t{ 7 });
+
+			static_assert(sizeof(SafeUnsigned<std::uint8_t, false>) == 1);
+			static_assert((SafeUnsigned<std::uint8_t, false>{ 3 } + SafeUnsigned<std::uint8_t, false>{ 4 }).get() == 7);
+		}
+
+		void testEngineAnalyze() {
+			Engine engine{ EngineOptions{ 1uz << 16 } };
+			Position pos;
+			pos.setPos(parsePositionCommand("fen 6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1")); //back rank mate in one
+
+			auto iterationCount = 0;
+			auto analysis = engine.analyze(pos, SearchLimits{ 3_su8 }, [&](const Analysis& iteration) {
+				iterationCount++;
+				assert_equality(iteration.principalVariation.empty(), false);
+			});
+			assert_equality(iterationCount > 0, true);
+			assert_equality(analysis.result.depth.get(), std::uint8_t{ 3 });
+			assert_equality(analysis.result.bestMove.has_value(), true);
+			assert_equality(analysis.principalVariation.front().getUCIString(), std::string{ "a1a8" });
+			assert_equality(analysis.principalVariation.size() <= 3uz, true);
+
+			//every principal variation move must be legal in the position it is played from
+			auto curr = pos;
+			for (const auto& move : analysis.principalVariation) {
+				auto posData = calcPositionData(curr);
+				assert_equality(std::ranges::contains(posData.legalMoves, move), true);
+				curr = Position{ curr, move };
+			}
+			arena::resetThread();
+		}
+
+		//a cancel that arrives before the search starts must still stop it, otherwise an unlimited search never returns
+		void testCancelBeforeSearch() {
+			IsolatedSearch search{ 1uz << 16 };
+			Position pos;
+			pos.setPos(parsePositionCommand("startpos"));
+			RepetitionMap repetitionMap;
+			repetitionMap.push(pos);
+
+			search.cancel();
+			auto result = std::async(std::launch::async, [&] {
+				arena::registerThread(std::this_thread::get_id());
+				return search.search(pos, repetitionMap, SearchLimits{});
+			});
+			auto finished = result.wait_for(std::chrono::seconds{ 10 }) == std::future_status::ready;
+			search.cancel(); //lets the search return if the first cancel was lost
+			assert_equality(finished, true);
+			result.get();
+
+			//resetCancel makes the next search run to its limits again
+			search.resetCancel();
+			auto limited = search.search(pos, repetitionMap, SearchLimits{ 2_su8 });
+			assert_equality(limited.depth.get(), std::uint8_t{ 2 });
+			arena::resetThread();
+		}
+
+		//a book path from a GUI that can't be read must be reported, not end the engine
+		void testOpeningBookLoadErrors() {
+			assert_equality(OpeningBook::load(std::filesystem::temp_directory_path()).has_value(), false);
+			assert_equality(OpeningBook::load(std::filesystem::temp_directory_path() / "agent_smith_missing_book.bin").has_value(), false);
+		}
+
+		void testCAPI() {
+			constexpr std::string_view KIWIPETE = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+			std::array<agent_smith_position, 2> positions;
+			assert_equality(agent_smith_parse_fen(STARTING_FEN_STRING.data(), STARTING_FEN_STRING.size(), &positions[0]), AGENT_SMITH_OK);
+			assert_equality(agent_smith_parse_fen(KIWIPETE.data(), KIWIPETE.size(), &positions[1]), AGENT_SMITH_OK);
+			assert_equality(agent_smith_parse_fen("8/8/8 w - -", 11, &positions[1]) == AGENT_SMITH_INVALID_FEN, true);
+			assert_equality(agent_smith_parse_fen(KIWIPETE.data(), KIWIPETE.size(), &positions[1]), AGENT_SMITH_OK);
+
+			std::array<char, AGENT_SMITH_MAX_FEN_LENGTH + 1> fen;
+			auto fenLength = agent_smith_write_fen(&positions[0], fen.data(), fen.size());
+			assert_equality((std::string_view{ fen.data(), fenLength }), STARTING_FEN_STRING);
+
+			std::array<agent_smith_move, 2 * AGENT_SMITH_MAX_MOVES> moves;
+			std::array<std::uint32_t, 3> moveOffsets;
+			assert_equality(agent_smith_generate_moves(positions.data(), positions.size(), moves.data(), moves.size(), moveOffsets.data()), 
+				AGENT_SMITH_OK);
+			assert_equality(moveOffsets[1], 20u);
+			assert_equality(moveOffsets[2] - moveOffsets[1], 48u);
+			assert_equality(agent_smith_generate_moves(positions.data(), positions.size(), moves.data(), 30, moveOffsets.data()), 
+				AGENT_SMITH_BUFFER_TOO_SMALL);
+
+			std::array<float, 2> ratings;
+			assert_equality(agent_smith_evaluate(positions.data(), positions.size(), ratings.data()), AGENT_SMITH_OK);
+			Position pos;
+			pos.setPos(parsePositionCommand("startpos"));
+			assert_equality(ratings[0], staticEvaluation(pos, calcPositionData(pos)));
+			arena::resetThread();
+
+			std::array<agent_smith_move, 2> bestMoves;
+			assert_equality(agent_smith_search(positions.data(), positions.size(), 0, bestMoves.data(), ratings.data()), 
+				AGENT_SMITH_INVALID_ARGUMENT);
+			assert_equality(agent_smith_search(positions.data(), positions.size(), 2, bestMoves.data(), ratings.data()), AGENT_SMITH_OK);
+			assert_equality(bestMoves[0] != 0 && bestMoves[1] != 0, true);
+
+			//a position without kings is rejected instead of being searched
+			agent_smith_position kingless{};
+			assert_equality(agent_smith_search(&kingless, 1, 2, bestMoves.data(), ratings.data()), AGENT_SMITH_INVALID_ARGUMENT);
+			assert_equality(agent_smith_evaluate(&kingless, 1, ratings.data()), AGENT_SMITH_INVALID_ARGUMENT);
+			assert_equality(agent_smith_write_fen(&kingless, fen.data(), fen.size()), 0uz);
+
+			//en passant squares off the 6th rank with white to move, or without a black pawn in front of them, are rejected
+			auto badEnPassant = positions[1];
+			badEnPassant.en_passant_square = static_cast<std::uint8_t>(Square::D1);
+			assert_equality(agent_smith_evaluate(&badEnPassant, 1, ratings.data()), AGENT_SMITH_INVALID_ARGUMENT);
+			badEnPassant.en_passant_square = static_cast<std::uint8_t>(Square::E6); //e5 holds a white knight
+			assert_equality(agent_smith_evaluate(&badEnPassant, 1, ratings.data()), AGENT_SMITH_INVALID_ARGUMENT);
+		}
+
+		void testSearchParameters() {
+			auto lmrDivisor = findTunableParameter("lmr_divisor");
+			assert_equality(lmrDivisor.has_value(), true);
+			assert_equality(findTunableParameter("unknown").has_value(), false);
+
+			EngineConfig config{ "tuned", SearchLimits{ 3_su8 } };
+			lmrDivisor->apply(config.parameters, 0.1);
+			assert_equality(config.parameters.lmrDivisor, lmrDivisor->min); //clamped
+			findTunableParameter("killer_moves")->apply(config.parameters, 1.4);
+			assert_equality(config.parameters.killerMoves, 1uz); //rounded
+
+			auto path = std::filesystem::temp_directory_path() / "chess_engine_config.json";
+			saveEngineConfig(config, path);
+			auto loaded = loadEngineConfig(path);
+			std::filesystem::remove(path);
+			assert_equality(loaded.limits.depth.get(), std::uint8_t{ 3 });
+			for (const auto& parameter : getTunableParameters()) {
+				assert_equality(parameter.get(loaded.parameters), parameter.get(config.parameters));
+			}
+
+			//the search must still see the back rank mate with a single killer move and aggressive reductions
+			IsolatedSearch search{ 1uz << 16 };
+			search.setParameters(loaded.parameters);
+			Position pos;
+			pos.setPos(parsePositionCommand("fen 6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1"));
+			RepetitionMap repetitionMap;
+			repetitionMap.push(pos);
+			auto result = search.search(pos, repetitionMap, loaded.limits);
+			assert_equality(result.bestMove.has_value(), true);
+			assert_equality(result.bestMove->getUCIString(), std::string{ "a1a8" });
+		}
+
+		void testPolyglotHash() {
+			//key test vectors from the Polyglot book format specification
+			constexpr std::array<std::pair<std::string_view, std::uint64_t>, 9> POSITIONS{ {
+				{ "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 0x463b96181691fc9c },
+				{ "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", 0x823c9b50fd114196 },
+				{ "rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2", 0x0756b94461c50fb0 },
+				{ "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2", 0x662fafb965db29d4 },
+				{ "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", 0x22a48b5a8e47ff78 }, //capturable en passant
+				{ "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR b kq - 0 3", 0x652a607ca3f242c1 }, //black castling only
+				{ "rnbq1bnr/ppp1pkpp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR w - - 0 4", 0x00fdd303c946bdd9 },
+				{ "rnbqkbnr/p1pppppp/8/8/PpP4P/8/1P1PPPP1/RNBQKBNR b KQkq c3 0 3", 0x3c8123ea7b067637 },
+				{ "rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4", 0x5c3f9b829b279560 }, //white kingside only
+			} };
+			for (const auto& [fen, key] : POSITIONS) {
+				Position pos;
+				assert_equality(pos.setFEN(fen).has_value(), true);
+				assert_equality(pos.polyglotHash(), key);
+			}
+		}
+
 		void runAllTests() {
 			std::println("Running tests...");
 
@@ -514,6 +893,20 @@ namespace chess {
 			testRepetition();
 			testRepetition2();
 			testCheckmate();
+			testEPDParsing();
+			testSANDisambiguation();
+			testPGNReading();
+			testPackedPositionRoundTrip();
+			testThreadPlacement();
+			testTurnDataSides();
+			testFENRoundTrip();
+			testSafeUnsignedProfiles();
+			testEngineAnalyze();
+			testCancelBeforeSearch();
+			testOpeningBookLoadErrors();
+			testCAPI();
+			testSearchParameters();
+			testPolyglotHash();
 			std::println("Finished tests");
 			//testUCIInput(); //long!
 		}
@@ -1,5 +1,7 @@
 export module Chess.Tests;
 
+export import :UCILatency;
+
 export namespace chess {
 	namespace tests {
 		void runAllTests();
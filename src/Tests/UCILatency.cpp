@@ -0,0 +1,92 @@
+module Chess.Tests:UCILatency;
+
+import :Pipe;
+
+namespace chess {
+	namespace tests {
+		struct LatencySamples {
+			std::string_view name;
+			std::vector<std::chrono::nanoseconds> latencies;
+			size_t missingCount = 0;
+		};
+
+		//writes command and records the time until a line starting with response arrives
+		void measureResponse(const Pipe& pipe, std::string_view command, std::string_view response, std::chrono::milliseconds timeout,
+			LatencySamples& samples) 
+		{
+			auto start = std::chrono::steady_clock::now();
+			pipe.write(command);
+			if (pipe.tryRead(response, timeout)) {
+				samples.latencies.push_back(std::chrono::steady_clock::now() - start);
+			} else {
+				samples.missingCount++;
+			}
+		}
+
+		//reads past everything the engine has printed so far, so that a response that missed its timeout can't be taken for
+		//the response to the next request
+		bool drainUntilReady(const Pipe& pipe, std::chrono::milliseconds timeout) {
+			pipe.write("isready\n");
+			return pipe.tryRead("readyok", timeout).has_value();
+		}
+
+		void printLatencies(std::span<LatencySamples> allSamples) {
+			std::println("{:<20} {:>8} {:>8} {:>10} {:>10} {:>10} {:>10} {:>10}", "request", "samples", "missing", "min us", "p50 us", 
+				"p90 us", "p99 us", "max us");
+			for (auto& samples : allSamples) {
+				auto& latencies = samples.latencies;
+				if (latencies.empty()) {
+					std::println("{:<20} {:>8} {:>8}", samples.name, 0, samples.missingCount);
+					continue;
+				}
+
+				std::ranges::sort(latencies);
+				auto percentile = [&latencies](double p) {
+					auto index = static_cast<size_t>(p * static_cast<double>(latencies.size() - 1) + 0.5);
+					return std::chrono::duration<double, std::micro>{ latencies[index] }.count();
+				};
+				std::println("{:<20} {:>8} {:>8} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f}", samples.name, latencies.size(), 
+					samples.missingCount, percentile(0.0), percentile(0.5), percentile(0.9), percentile(0.99), percentile(1.0));
+			}
+		}
+
+		void measureUCILatency(const UCILatencyOptions& options) {
+			std::array<std::string, 2> args{ "uci", std::to_string(options.depth) };
+			Pipe pipe{ args };
+
+			LatencySamples uci{ "uci -> uciok" };
+			LatencySamples isReady{ "isready -> readyok" };
+			//the engine prints its only info line right before bestmove, so this is the time to reach the search depth
+			LatencySamples go{ "go -> bestmove" };
+			LatencySamples stop{ "stop -> bestmove" };
+
+			std::println("Measuring {} iterations at depth {}...", options.iterations, static_cast<std::uint32_t>(options.depth));
+			auto measure = [&](std::string_view command, std::string_view response, LatencySamples& samples) {
+				if (drainUntilReady(pipe, options.timeout)) {
+					measureResponse(pipe, command, response, options.timeout, samples);
+				} else {
+					samples.missingCount++;
+				}
+			};
+			for (auto i = 0uz; i < options.iterations; i++) {
+				measure("uci\n", "uciok", uci);
+				pipe.write("ucinewgame\nposition startpos\n");
+				measure("isready\n", "readyok", isReady);
+				measure("go\n", "bestmove", go);
+
+				//a GUI stops a search that is still running, which a shallow search may already have finished. Draining
+				//before go instead of before stop keeps that bestmove as the response to stop.
+				if (drainUntilReady(pipe, options.timeout)) {
+					pipe.write("position startpos moves e2e4\ngo\n");
+					measureResponse(pipe, "stop\n", "bestmove", options.timeout, stop);
+				} else {
+					stop.missingCount++;
+				}
+				pipe.write("stop\n"); //let a stopped search wind down before the next uci command
+			}
+
+			std::array allSamples{ std::move(uci), std::move(isReady), std::move(go), std::move(stop) };
+			printLatencies(allSamples);
+		}
+	}
+}
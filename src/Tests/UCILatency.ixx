@@ -0,0 +1,16 @@
+export module Chess.Tests:UCILatency;
+
+import std;
+
+export namespace chess {
+	namespace tests {
+		struct UCILatencyOptions {
+			size_t iterations = 100;
+			std::uint8_t depth = 1; //kept shallow so that go -> bestmove is dominated by protocol and wake up overhead
+			std::chrono::milliseconds timeout{ 2000 }; //responses slower than this are counted as missing
+		};
+
+		//drives a child engine over UCI and prints the latency distribution of each request/response pair
+		void measureUCILatency(const UCILatencyOptions& options);
+	}
+}
@@ -0,0 +1,202 @@
+module;
+
+#ifdef _WIN64
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+module Chess.ThreadAffinity;
+
+namespace chess {
+	std::vector<LogicalProcessor> makeFlatTopology() {
+		std::vector<LogicalProcessor> ret;
+		for (auto i = 0u; i < std::thread::hardware_concurrency(); i++) {
+			ret.push_back({ i, i, 0 });
+		}
+		return ret;
+	}
+
+#ifdef _WIN64
+	//only the first processor group (64 logical processors) is supported
+	std::vector<LogicalProcessor> readProcessorTopology() {
+		DWORD byteCount = 0;
+		GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &byteCount);
+		std::vector<std::byte> buffer(byteCount);
+		auto info = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data());
+		if (!GetLogicalProcessorInformationEx(RelationProcessorCore, info, &byteCount)) {
+			return makeFlatTopology();
+		}
+
+		std::vector<LogicalProcessor> ret;
+		auto coreID = 0u;
+		for (auto offset = 0uz; offset < byteCount; coreID++) {
+			auto core = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data() + offset);
+			const auto& groupMask = core->Processor.GroupMask[0];
+			if (groupMask.Group == 0) {
+				for (auto id = 0u; id < 64; id++) {
+					if (groupMask.Mask & (KAFFINITY{ 1 } << id)) {
+						ret.push_back({ id, coreID, 0 });
+					}
+				}
+			}
+			offset += core->Size;
+		}
+		std::ranges::sort(ret, {}, &LogicalProcessor::id);
+		return ret.empty() ? makeFlatTopology() : ret;
+	}
+
+	bool pinThreadHandle(HANDLE thread, std::span<const std::uint32_t> processors) {
+		DWORD_PTR mask = 0;
+		for (auto processor : processors) {
+			if (processor < 64) {
+				mask |= DWORD_PTR{ 1 } << processor;
+			}
+		}
+		if (mask == 0) {
+			DWORD_PTR systemMask = 0;
+			GetProcessAffinityMask(GetCurrentProcess(), &mask, &systemMask);
+		}
+		return SetThreadAffinityMask(thread, mask) != 0;
+	}
+
+	bool pinThread(std::jthread& thread, std::span<const std::uint32_t> processors) {
+		return pinThreadHandle(thread.native_handle(), processors);
+	}
+
+	bool pinCurrentThread(std::span<const std::uint32_t> processors) {
+		return pinThreadHandle(GetCurrentThread(), processors);
+	}
+#else
+	std::optional<std::uint32_t> readTopologyValue(const std::filesystem::path& path) {
+		std::ifstream file{ path };
+		std::uint32_t ret = 0;
+		if (!(file >> ret)) {
+			return std::nullopt;
+		}
+		return ret;
+	}
+
+	std::vector<LogicalProcessor> readProcessorTopology() {
+		const std::filesystem::path CPU_DIRECTORY = "/sys/devices/system/cpu";
+
+		std::vector<LogicalProcessor> ret;
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator{ CPU_DIRECTORY, ec }) {
+			auto name = entry.path().filename().string();
+			std::uint32_t id = 0;
+			if (!name.starts_with("cpu") || std::from_chars(name.data() + 3, name.data() + name.size(), id).ptr != name.data() + name.size()) {
+				continue;
+			}
+
+			//offline processors have no topology directory
+			auto coreID = readTopologyValue(entry.path() / "topology" / "core_id");
+			auto packageID = readTopologyValue(entry.path() / "topology" / "physical_package_id");
+			if (coreID && packageID) {
+				ret.push_back({ id, *coreID, *packageID });
+			}
+		}
+		std::ranges::sort(ret, {}, &LogicalProcessor::id);
+		return ret.empty() ? makeFlatTopology() : ret;
+	}
+
+	bool pinThreadHandle(pthread_t thread, std::span<const std::uint32_t> processors) {
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		if (processors.empty()) {
+			for (const auto& processor : readProcessorTopology()) {
+				CPU_SET(processor.id, &cpuSet);
+			}
+		}
+		for (auto processor : processors) {
+			if (processor < CPU_SETSIZE) {
+				CPU_SET(processor, &cpuSet);
+			}
+		}
+		return pthread_setaffinity_np(thread, sizeof(cpuSet), &cpuSet) == 0;
+	}
+
+	bool pinThread(std::jthread& thread, std::span<const std::uint32_t> processors) {
+		return pinThreadHandle(thread.native_handle(), processors);
+	}
+
+	bool pinCurrentThread(std::span<const std::uint32_t> processors) {
+		return pinThreadHandle(pthread_self(), processors);
+	}
+#endif
+
+	//the first processor of every physical core, then the second processor of every core, and so on
+	std::vector<LogicalProcessor> orderPhysicalCoresFirst(std::span<const LogicalProcessor> topology) {
+		std::map<std::pair<std::uint32_t, std::uint32_t>, int> siblingCounts;
+		std::vector<std::pair<int, LogicalProcessor>> ranked;
+		for (const auto& processor : topology) {
+			auto siblingRank = siblingCounts[{ processor.packageID, processor.coreID }]++;
+			ranked.emplace_back(siblingRank, processor);
+		}
+		std::ranges::stable_sort(ranked, {}, [](const auto& rankedProcessor) {
+			return rankedProcessor.first;
+		});
+		return ranked | std::views::values | std::ranges::to<std::vector>();
+	}
+
+	PlacementPlan planThreadPlacement(const ThreadPlacement& placement, std::span<const LogicalProcessor> topology) {
+		PlacementPlan ret;
+		if (!placement.pinThreads || topology.empty()) {
+			return ret;
+		}
+
+		auto ordered = orderPhysicalCoresFirst(topology);
+
+		//reserve whole physical cores, so the I/O thread doesn't share a core with a search thread
+		std::set<std::pair<std::uint32_t, std::uint32_t>> reservedCores;
+		for (const auto& processor : ordered) {
+			if (reservedCores.size() >= placement.reservedIOCores) {
+				break;
+			}
+			reservedCores.insert({ processor.packageID, processor.coreID });
+		}
+		auto isReserved = [&](const LogicalProcessor& processor) {
+			return reservedCores.contains({ processor.packageID, processor.coreID });
+		};
+
+		if (!placement.preferPhysicalCores) {
+			ordered.assign(topology.begin(), topology.end());
+		}
+		for (const auto& processor : ordered) {
+			if (isReserved(processor)) {
+				ret.ioProcessors.push_back(processor.id);
+			} else if (placement.processors.empty() || std::ranges::contains(placement.processors, processor.id)) {
+				ret.searchProcessors.push_back(processor.id);
+			}
+		}
+
+		//never leave the search threads without a processor
+		if (ret.searchProcessors.empty()) {
+			ret.searchProcessors = ordered | std::views::transform(&LogicalProcessor::id) | std::ranges::to<std::vector>();
+		}
+		return ret;
+	}
+
+	std::optional<std::vector<std::uint32_t>> parseProcessorList(std::string_view list) {
+		std::vector<std::uint32_t> ret;
+		for (auto part : list | std::views::split(',')) {
+			std::string_view range{ part.begin(), part.end() };
+			auto dash = range.find('-');
+			auto firstStr = range.substr(0, dash);
+			auto lastStr = dash == std::string_view::npos ? firstStr : range.substr(dash + 1);
+
+			std::uint32_t first = 0;
+			std::uint32_t last = 0;
+			auto firstRes = std::from_chars(firstStr.data(), firstStr.data() + firstStr.size(), first);
+			auto lastRes = std::from_chars(lastStr.data(), lastStr.data() + lastStr.size(), last);
+			if (firstRes.ec != std::errc{} || firstRes.ptr != firstStr.data() + firstStr.size() ||
+				lastRes.ec != std::errc{} || lastRes.ptr != lastStr.data() + lastStr.size() || last < first || last >= MAX_PROCESSOR_ID)
+			{
+				return std::nullopt;
+			}
+			ret.append_range(std::views::iota(first, last + 1)); //can't overflow, since last is below MAX_PROCESSOR_ID
+		}
+		return ret;
+	}
+}
@@ -0,0 +1,38 @@
+export module Chess.ThreadAffinity;
+
+import std;
+
+export namespace chess {
+	struct LogicalProcessor {
+		std::uint32_t id = 0;
+		std::uint32_t coreID = 0; //SMT siblings share a core ID within a package
+		std::uint32_t packageID = 0;
+	};
+
+	//one entry per online logical processor, sorted by id
+	std::vector<LogicalProcessor> readProcessorTopology();
+
+	struct ThreadPlacement {
+		bool pinThreads = false;
+		bool preferPhysicalCores = true; //use one processor per physical core before using SMT siblings
+		size_t reservedIOCores = 0; //physical cores kept free of search threads for the UCI I/O thread
+		std::vector<std::uint32_t> processors; //if not empty, search threads are only placed on these processors
+	};
+
+	struct PlacementPlan {
+		std::vector<std::uint32_t> ioProcessors; //empty if the I/O thread isn't pinned
+		std::vector<std::uint32_t> searchProcessors; //search thread i goes on searchProcessors[i % size]; empty if unpinned
+	};
+
+	PlacementPlan planThreadPlacement(const ThreadPlacement& placement, std::span<const LogicalProcessor> topology);
+
+	//processor ids at or above this are rejected, so that a bad list can't make the engine allocate billions of entries
+	constexpr std::uint32_t MAX_PROCESSOR_ID = 4096;
+
+	//parses lists like "0,2,4-7". std::nullopt if the list is malformed or names an id of MAX_PROCESSOR_ID or above.
+	std::optional<std::vector<std::uint32_t>> parseProcessorList(std::string_view list);
+
+	//restricts the thread to the processors, or lets it run anywhere again if processors is empty
+	bool pinThread(std::jthread& thread, std::span<const std::uint32_t> processors);
+	bool pinCurrentThread(std::span<const std::uint32_t> processors);
+}
@@ -0,0 +1,99 @@
+module Chess.Tuning;
+
+import Chess.EasyRandom;
+import Chess.EPD;
+
+namespace chess {
+	//perturbations decay to TunableParameter::step and step sizes to learningRate * step^2 by the last iteration, so that
+	//the same options suit parameters of any scale
+	class SPSASchedule {
+	private:
+		const SPSAOptions& m_options;
+		double m_iterations = 0.0;
+		double m_stability = 0.0; //delays the step size decay, so early iterations don't take huge steps
+	public:
+		SPSASchedule(const SPSAOptions& options)
+			: m_options{ options }, m_iterations{ static_cast<double>(options.iterations) }, m_stability{ 0.1 * static_cast<double>(options.iterations) }
+		{
+		}
+
+		double perturbation(const TunableParameter& parameter, size_t iteration) const {
+			return parameter.step * std::pow(m_iterations / static_cast<double>(iteration + 1), m_options.gamma);
+		}
+
+		double stepSize(const TunableParameter& parameter, size_t iteration) const {
+			auto finalStepSize = m_options.learningRate * parameter.step * parameter.step;
+			auto decay = std::pow((m_stability + m_iterations) / (m_stability + static_cast<double>(iteration + 1)), m_options.alpha);
+			return finalStepSize * decay;
+		}
+	};
+
+	size_t calcGamesPerIteration(const SPSAOptions& options) {
+		auto ret = options.gamesPerIteration;
+		if (ret == 0) {
+			ret = 2uz * std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		return ret + ret % 2;
+	}
+
+	void printIteration(size_t iteration, const SPSAOptions& options, const MatchStats& stats, std::span<const double> theta) {
+		std::string parameters;
+		for (const auto& [parameter, value] : std::views::zip(getTunableParameters(), theta)) {
+			parameters += std::format(" {}={:.3f}", parameter.name, value);
+		}
+		std::println("Iteration {}/{} | +{} ={} -{} |{}", iteration + 1, options.iterations, stats.wins, stats.draws, stats.losses, parameters);
+	}
+
+	SearchParameters runSPSA(const SPSAOptions& options) {
+		auto openings = loadEPDFile(options.openingsPath);
+		if (openings.empty()) {
+			std::println("Error: no openings in {}", options.openingsPath.string());
+			return options.start;
+		}
+		auto positions = openings | std::views::transform(&EPDEntry::pos) | std::ranges::to<std::vector>();
+
+		auto tunables = getTunableParameters();
+		auto theta = tunables | std::views::transform([&](const TunableParameter& parameter) {
+			return parameter.get(options.start);
+		}) | std::ranges::to<std::vector>();
+		std::vector<double> directions(tunables.size());
+
+		SelfPlayOptions match;
+		match.gameCount = calcGamesPerIteration(options);
+		match.first = { "plus", options.limits, options.start };
+		match.second = { "minus", options.limits, options.start };
+		match.stopOnSPRT = false;
+		match.printProgress = false;
+
+		EngineConfig tuned{ "spsa", options.limits, options.start };
+		SelfPlayRunner runner;
+		SPSASchedule schedule{ options };
+
+		for (auto iteration = 0uz; iteration < options.iterations; iteration++) {
+			for (auto&& [parameter, value, direction] : std::views::zip(tunables, theta, directions)) {
+				direction = makeRandomNum(0, 1) == 0 ? -1.0 : 1.0;
+				auto perturbation = schedule.perturbation(parameter, iteration) * direction;
+				parameter.apply(match.first.parameters, value + perturbation);
+				parameter.apply(match.second.parameters, value - perturbation);
+			}
+
+			auto stats = runner.play(match, positions);
+			auto result = static_cast<double>(stats.wins) - static_cast<double>(stats.losses);
+
+			//result * direction / perturbation estimates the gradient, up to a constant that the learning rate absorbs
+			for (auto&& [parameter, value, direction] : std::views::zip(tunables, theta, directions)) {
+				auto gain = schedule.stepSize(parameter, iteration) / schedule.perturbation(parameter, iteration);
+				value = std::clamp(value + gain * result * direction, parameter.min, parameter.max);
+				parameter.apply(tuned.parameters, value);
+			}
+
+			if (options.printProgress) {
+				printIteration(iteration, options, stats, theta);
+			}
+			if (!options.outputPath.empty()) {
+				saveEngineConfig(tuned, options.outputPath);
+			}
+		}
+		return tuned.parameters;
+	}
+}
@@ -0,0 +1,25 @@
+export module Chess.Tuning;
+
+import std;
+
+export import Chess.MoveSearch;
+export import Chess.SelfPlay;
+
+export namespace chess {
+	struct SPSAOptions {
+		std::filesystem::path openingsPath;
+		std::filesystem::path outputPath; //engine config holding the tuned parameters, rewritten after every iteration. Empty to skip.
+		SearchLimits limits;
+		SearchParameters start;
+		size_t iterations = 1000;
+		size_t gamesPerIteration = 0; //0 plays two games per hardware thread. Odd counts are rounded up, so each opening is played as both colors.
+		double learningRate = 0.002;  //step size relative to the squared perturbation, as of the last iteration
+		double alpha = 0.602;         //step size decay
+		double gamma = 0.101;         //perturbation decay
+		bool printProgress = true;
+	};
+
+	//simultaneous perturbation stochastic approximation: every iteration plays the parameters nudged one way against the
+	//parameters nudged the opposite way, and moves the parameters towards the side that scored better
+	SearchParameters runSPSA(const SPSAOptions& options);
+}
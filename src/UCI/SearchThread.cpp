@@ -4,15 +4,37 @@ module;
 
 module Chess.UCI:SearchThread;
 
+import Chess.Arena;
 import Chess.Assert;
 import Chess.DebugPrint;
 import Chess.MoveSearch;
+import Chess.PerfCounters;
 import Chess.PositionCommand;
 import Chess.Position.RepetitionMap;
 
 using namespace std::literals;
 
 namespace chess {
+	void printHardwareCounters(const SearchStats& stats) {
+		if (stats.hardware[perf::Event::Cycles] == 0) {
+			return;
+		}
+		std::println("info string ipc {:.2f} l1dmisses/node {:.2f} llcmisses/node {:.2f} branchmisses/node {:.2f}", stats.hardware.instructionsPerCycle(),
+			stats.hardware.perOperation(perf::Event::L1DMisses, stats.nodes), stats.hardware.perOperation(perf::Event::LLCMisses, stats.nodes),
+			stats.hardware.perOperation(perf::Event::BranchMisses, stats.nodes));
+	}
+
+	void SearchThread::applyPendingParameters() {
+		std::optional<SearchParameters> parameters;
+		{
+			std::scoped_lock l{ m_mutex };
+			parameters = std::exchange(m_pendingParameters, std::nullopt);
+		}
+		if (parameters) {
+			m_searcher.setParameters(*parameters); //only this thread searches, so no search is running
+		}
+	}
+
 	void SearchThread::think(std::stop_token stopToken) {
 		while (!stopToken.stop_requested()) {
 			{
@@ -34,6 +56,7 @@ namespace chess {
 			auto stateCopy = m_state;
 			ul.unlock();
 
+			applyPendingParameters();
 			auto move = m_searcher.findBestMove(stateCopy.pos, 255_su8, stateCopy.repetitionMap);
 			if (!move) { //if the position has no legal moves, then reset to an invalid position state
 				std::scoped_lock l{ m_mutex };
@@ -47,6 +70,8 @@ namespace chess {
 	void SearchThread::run(std::stop_token stopToken) {
 		using namespace std::literals;
 
+		arena::registerThread(std::this_thread::get_id()); //book probes check legality with arena allocated position data
+
 		while (!stopToken.stop_requested()) {
 			think(stopToken);
 			if (stopToken.stop_requested()) {
@@ -60,9 +85,19 @@ namespace chess {
 				m_calculationRequested = false;
 			}
 
+			applyPendingParameters();
+			auto start = std::chrono::steady_clock::now();
 			if (auto bestMove = m_searcher.findBestMove(stateCopy.pos, stateCopy.depth, stateCopy.repetitionMap)) {
 				if (!stopToken.stop_requested()) {
-					std::println("{}", bestMove->getUCIString()); //prepends "bestmove"
+					auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+					auto stats = m_searcher.getStats();
+					if (stats.nodes != 0) { //book moves aren't searched, so there are no stats to report
+						auto nps = stats.nodes * 1000 / static_cast<std::uint64_t>(std::max(elapsed, 1ms).count());
+						std::println("info depth {} seldepth {} nodes {} nps {} time {}", static_cast<std::uint32_t>(stateCopy.depth.get()), 
+							static_cast<std::uint32_t>(stats.selectiveDepth), stats.nodes, nps, elapsed.count());
+						printHardwareCounters(stats);
+					}
+					std::println("bestmove {}", bestMove->getUCIString());
 					std::fflush(stdout);
 
 					//don't wait for the GUI to send the next position - start thinking immediately on the next move
@@ -109,6 +144,32 @@ namespace chess {
 		m_cv.notify_one();
 	}
 
+	void SearchThread::setOpeningBook(std::shared_ptr<const OpeningBook> book) {
+		m_searcher.setOpeningBook(std::move(book)); //internally synchronized
+	}
+
+	void SearchThread::setParameters(const SearchParameters& parameters) {
+		std::scoped_lock l{ m_mutex };
+		m_pendingParameters = parameters;
+	}
+
+	void SearchThread::pinSearchThreads(std::span<const std::uint32_t> processors) {
+		m_searcher.pinThreads(processors); //affinity can be changed while the threads are searching
+	}
+
+	void SearchThread::printStats() const {
+		auto stats = m_searcher.getStats(); //lock free, so this doesn't wait for the search
+		auto percentOfCutoffs = [&stats](std::uint64_t count) {
+			return stats.betaCutoffs == 0 ? 0.0 : 100.0 * static_cast<double>(count) / static_cast<double>(stats.betaCutoffs);
+		};
+		std::println("info string nodes {} leafnodes {} tthits {} seldepth {}", stats.nodes, stats.leafNodes, stats.positionTableHits,
+			static_cast<std::uint32_t>(stats.selectiveDepth));
+		std::println("info string betacutoffs {} firstmovecutoffs {} ({:.1f}%) lmrresearches {}", stats.betaCutoffs, stats.firstMoveCutoffs,
+			percentOfCutoffs(stats.firstMoveCutoffs), stats.lmrResearches);
+		printHardwareCounters(stats);
+		std::fflush(stdout);
+	}
+
 	void SearchThread::stop() { 
 		m_searcher.cancel(); //internally synchronized
 		{
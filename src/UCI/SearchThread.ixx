@@ -5,6 +5,7 @@ export import std;
 import Chess.Position;
 import Chess.Position.RepetitionMap;
 import Chess.MoveSearch;
+import Chess.OpeningBook;
 import Chess.SafeInt;
 
 namespace chess {
@@ -21,9 +22,11 @@ namespace chess {
 		GameState m_state;
 		bool m_shouldPonder = false;
 		bool m_calculationRequested = false;
+		std::optional<SearchParameters> m_pendingParameters; //applied by the search thread before its next search
 		std::condition_variable_any m_cv;
 		std::jthread m_thread; //thread is destroyed before all other members
 
+		void applyPendingParameters();
 		void think(std::stop_token stopToken);
 		void run(std::stop_token stopToken);
 	public:
@@ -33,5 +36,9 @@ namespace chess {
 		void stop();
 		void setPosition(GameState gameState);
 		void go(SafeUnsigned<std::uint8_t> depth);
+		void setOpeningBook(std::shared_ptr<const OpeningBook> book);
+		void setParameters(const SearchParameters& parameters); //takes effect from the next search
+		void pinSearchThreads(std::span<const std::uint32_t> processors);
+		void printStats() const;
 	};
 }
\ No newline at end of file
@@ -8,8 +8,12 @@ import std;
 
 import Chess.DebugPrint;
 import Chess.Evaluation;
+import Chess.MoveSearch;
+import Chess.OpeningBook;
+import Chess.PerfCounters;
 import Chess.Position.RepetitionMap;
 import Chess.PositionCommand;
+import Chess.ThreadAffinity;
 
 import :SearchThread;
 
@@ -37,8 +41,130 @@ namespace chess {
 		return ret;
 	}
 
+	struct UCIOption {
+		std::string name;
+		std::string value;
+	};
+
+	//setoption name <name> [value <value>]; names and values may contain spaces
+	UCIOption parseSetOption(std::istringstream& iss) {
+		UCIOption ret;
+		std::string token;
+		std::string* field = nullptr;
+		while (iss >> token) {
+			if (token == "name") {
+				field = &ret.name;
+			} else if (token == "value" && field == &ret.name) {
+				field = &ret.value;
+			} else if (field) {
+				if (!field->empty()) {
+					field->push_back(' ');
+				}
+				field->append(token);
+			}
+		}
+		return ret;
+	}
+
+	void applyThreadPlacement(SearchThread& searchThread, const ThreadPlacement& placement) {
+		auto plan = planThreadPlacement(placement, readProcessorTopology());
+		searchThread.pinSearchThreads(plan.searchProcessors);
+		pinCurrentThread(plan.ioProcessors); //this thread handles the UCI I/O
+	}
+
+	std::optional<bool> parseCheckValue(std::string_view value) {
+		if (value == "true") {
+			return true;
+		} else if (value == "false") {
+			return false;
+		}
+		return std::nullopt;
+	}
+
+	void setOption(SearchThread& searchThread, ThreadPlacement& placement, SearchParameters& parameters, const UCIOption& option) {
+		auto printInvalidValue = [&option] {
+			std::println("info string invalid value {} for option {}", option.value, option.name);
+			std::fflush(stdout);
+		};
+
+		if (option.name == "PinThreads" || option.name == "PreferPhysicalCores") {
+			auto value = parseCheckValue(option.value);
+			if (!value) {
+				printInvalidValue();
+				return;
+			}
+			if (option.name == "PinThreads") {
+				placement.pinThreads = *value;
+			} else {
+				placement.preferPhysicalCores = *value;
+			}
+			applyThreadPlacement(searchThread, placement);
+		} else if (option.name == "ReservedIOCores") {
+			size_t reservedCores = 0;
+			auto [ptr, ec] = std::from_chars(option.value.data(), option.value.data() + option.value.size(), reservedCores);
+			if (ec != std::errc{}) {
+				printInvalidValue();
+				return;
+			}
+			placement.reservedIOCores = reservedCores;
+			applyThreadPlacement(searchThread, placement);
+		} else if (option.name == "ProcessorList") {
+			if (option.value.empty() || option.value == "<empty>") {
+				placement.processors.clear();
+			} else if (auto processors = parseProcessorList(option.value)) {
+				placement.processors = std::move(*processors);
+			} else {
+				printInvalidValue();
+				return;
+			}
+			applyThreadPlacement(searchThread, placement);
+		} else if (option.name == "HardwareCounters") {
+			auto value = parseCheckValue(option.value);
+			if (!value) {
+				printInvalidValue();
+				return;
+			}
+			perf::setEnabled(*value);
+			if (*value && !perf::isAvailable()) {
+				std::println("info string hardware counters are unavailable on this system");
+				std::fflush(stdout);
+			}
+		} else if (auto parameter = findTunableParameter(option.name)) {
+			std::int64_t spin = 0;
+			auto [ptr, ec] = std::from_chars(option.value.data(), option.value.data() + option.value.size(), spin);
+			if (ec != std::errc{}) {
+				printInvalidValue();
+				return;
+			}
+			parameter->apply(parameters, parameter->fromSpin(spin));
+			searchThread.setParameters(parameters);
+		} else if (option.name == "BookFile") {
+			if (option.value.empty() || option.value == "<empty>") {
+				searchThread.setOpeningBook(nullptr);
+			} else if (auto book = OpeningBook::load(option.value)) {
+				searchThread.setOpeningBook(std::make_shared<const OpeningBook>(std::move(*book)));
+			} else {
+				std::println("info string could not load book file: {}", book.error());
+				std::fflush(stdout);
+			}
+		}
+	}
+
+	//the tunable search parameters, as spin options named after the parameters
+	std::string getSearchParameterOptions() {
+		std::string ret;
+		SearchParameters defaults;
+		for (const auto& parameter : getTunableParameters()) {
+			ret += std::format("option name {} type spin default {} min {} max {}\n", parameter.name, parameter.toSpin(parameter.get(defaults)),
+				parameter.toSpin(parameter.min), parameter.toSpin(parameter.max));
+		}
+		return ret;
+	}
+
 	void playUCI(SafeUnsigned<std::uint8_t> depth) {
 		SearchThread searchThread;
+		ThreadPlacement placement;
+		SearchParameters parameters;
 
 		std::istringstream iss;
 		std::string line;
@@ -52,7 +178,7 @@ namespace chess {
 				break;
 			}
 
-			debugPrint(std::format("{}", line)); //DOES NOT SEND TO stdout
+			debugPrint("{}", line); //DOES NOT SEND TO stdout
 			
 			iss.clear();
 			iss.str(line);
@@ -74,14 +200,24 @@ namespace chess {
 			} else if (token == "uci") {
 				constexpr auto ENGINE_INFO = "id name Agent Smith\n"
 											 "id author Walter Stein-Smith\n"
-											 "uciok\n";
-				debugPrint(ENGINE_INFO);
-				std::printf(ENGINE_INFO);
+											 "option name BookFile type string default <empty>\n"
+											 "option name PinThreads type check default false\n"
+											 "option name PreferPhysicalCores type check default true\n"
+											 "option name ReservedIOCores type spin default 0 min 0 max 64\n"
+											 "option name ProcessorList type string default <empty>\n"
+											 "option name HardwareCounters type check default false\n";
+				auto engineInfo = std::format("{}{}uciok\n", ENGINE_INFO, getSearchParameterOptions());
+				debugPrint("{}", engineInfo);
+				std::printf("%s", engineInfo.c_str());
 				std::fflush(stdout);
 			} else if (token == "go") {
 				searchThread.go(depth); 
 			} else if (token == "stop") {
 				searchThread.stop();
+			} else if (token == "search_stats") { //debugging command, not part of UCI
+				searchThread.printStats();
+			} else if (token == "setoption") {
+				setOption(searchThread, placement, parameters, parseSetOption(iss));
 			}
 		}
 	}
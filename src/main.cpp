@@ -1,13 +1,22 @@
 import std;
 
+import Chess.AnalysisServer;
 import Chess.Arena;
 import Chess.BitboardImage;
+import Chess.DataGeneration;
+import Chess.EPDSuite;
 import Chess.MoveGeneration;
 import Chess.UCI;
 import Chess.MeasureMoveTime;
+import Chess.Microbenchmarks;
 import Chess.Move;
+import Chess.MoveSearch;
+import Chess.PGN;
+import Chess.Profiler;
 import Chess.SafeInt;
+import Chess.SelfPlay;
 import Chess.Tests;
+import Chess.Tuning;
 
 namespace chess {
 	void handleBitboardInput(const char** argv, int argc) {
@@ -73,6 +82,241 @@ namespace chess {
 		playUCI(depth);
 	}
 
+	std::optional<std::uint32_t> parseUnsignedArgument(const char* arg) {
+		std::uint32_t ret = 0;
+		auto argEnd = arg + std::strlen(arg);
+		auto res = std::from_chars(arg, argEnd, ret, 10);
+		if (res.ec != std::errc{} || res.ptr != argEnd) {
+			return std::nullopt;
+		}
+		return ret;
+	}
+
+	std::optional<SearchLimits> parseSearchLimits(const char* limitType, const char* limitValue) {
+		auto value = parseUnsignedArgument(limitValue);
+		if (!value) {
+			std::println("Error: could not parse {} argument", limitType);
+			return std::nullopt;
+		}
+
+		SearchLimits ret;
+		if (std::strcmp(limitType, "depth") == 0) {
+			if (*value < 1 || *value > MAX_SEARCH_DEPTH.get()) {
+				std::println("Error: depth must be between 1 and {}", static_cast<std::uint32_t>(MAX_SEARCH_DEPTH.get()));
+				return std::nullopt;
+			}
+			ret.depth = SafeUnsigned{ static_cast<std::uint8_t>(*value) };
+		} else if (std::strcmp(limitType, "movetime") == 0) {
+			ret.moveTime = std::chrono::milliseconds{ *value };
+		} else {
+			std::println("Error: search limit must be either depth or movetime");
+			return std::nullopt;
+		}
+		return ret;
+	}
+
+	void runSuite(const char** argv, int argc) {
+		if (argc != 5) {
+			std::println("Error: suite requires 3 arguments: [file.epd, depth|movetime, value]");
+			return;
+		}
+		if (auto limits = parseSearchLimits(argv[3], argv[4])) {
+			runEPDSuite(argv[2], *limits);
+		}
+	}
+
+	void runSelfPlayMatch(const char** argv, int argc) {
+		if (argc != 6) {
+			std::println("Error: selfplay requires 4 arguments: [openings, game count, first engine config, second engine config]");
+			return;
+		}
+		auto gameCount = parseUnsignedArgument(argv[3]);
+		if (!gameCount) {
+			std::println("Error: could not parse game count argument");
+			return;
+		}
+
+		SelfPlayOptions options;
+		options.openingsPath = argv[2];
+		options.gameCount = *gameCount;
+		options.first = loadEngineConfig(argv[4]);
+		options.second = loadEngineConfig(argv[5]);
+		runSelfPlay(options);
+	}
+
+	void runSPSATuning(const char** argv, int argc) {
+		if (argc != 7) {
+			std::println("Error: spsa requires 5 arguments: [openings, iterations, depth|movetime, value, output.json]");
+			return;
+		}
+		auto iterations = parseUnsignedArgument(argv[3]);
+		if (!iterations) {
+			std::println("Error: could not parse iterations argument");
+			return;
+		}
+		auto limits = parseSearchLimits(argv[4], argv[5]);
+		if (!limits) {
+			return;
+		}
+
+		SPSAOptions options;
+		options.openingsPath = argv[2];
+		options.outputPath = argv[6];
+		options.iterations = *iterations;
+		options.limits = *limits;
+		runSPSA(options);
+	}
+
+	void printPGNStats(const char** argv, int argc) {
+		if (argc != 3) {
+			std::println("Error: pgn_stats requires 1 argument: [file.pgn]");
+			return;
+		}
+
+		std::array<std::atomic<size_t>, 4> resultCounts{};
+		auto start = std::chrono::steady_clock::now();
+		auto stats = readPGNFile(argv[2], [&](const PGNPosition& pgnPosition) {
+			if (pgnPosition.ply == 0) {
+				resultCounts[static_cast<size_t>(pgnPosition.result)]++;
+			}
+		});
+		std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+		std::println("Games: {} ({} unreadable)", stats.gameCount, stats.unreadableGameCount);
+		std::println("Results: 1-0: {}, 0-1: {}, 1/2-1/2: {}, unknown: {}", resultCounts[0].load(), resultCounts[1].load(), 
+			resultCounts[2].load(), resultCounts[3].load());
+		std::println("Positions: {} in {:.3f}s ({:.0f} positions/s)", stats.positionCount, seconds.count(), 
+			static_cast<double>(stats.positionCount) / seconds.count());
+	}
+
+	void runDataGeneration(const char** argv, int argc) {
+		if (argc != 4 && argc != 5) {
+			std::println("Error: datagen requires 2 or 3 arguments: [output file, game count, nodes per move]");
+			return;
+		}
+		auto gameCount = parseUnsignedArgument(argv[3]);
+		if (!gameCount) {
+			std::println("Error: could not parse game count argument");
+			return;
+		}
+
+		DataGenerationOptions options;
+		options.outputPath = argv[2];
+		options.gameCount = *gameCount;
+		if (argc == 5) {
+			auto nodes = parseUnsignedArgument(argv[4]);
+			if (!nodes || *nodes == 0) {
+				std::println("Error: could not parse nodes per move argument");
+				return;
+			}
+			options.nodesPerMove = *nodes;
+		}
+		generateTrainingData(options);
+	}
+
+	void runAnalysisServerMode(const char** argv, int argc) {
+		if (argc != 2 && argc != 3) {
+			std::println("Error: analyze_server takes at most 1 argument: [max threads per request]");
+			return;
+		}
+
+		AnalysisServerOptions options;
+		if (argc == 3) {
+			auto maxThreads = parseUnsignedArgument(argv[2]);
+			if (!maxThreads || *maxThreads == 0) {
+				std::println("Error: could not parse max threads per request argument");
+				return;
+			}
+			options.maxThreadsPerRequest = *maxThreads;
+		}
+		runAnalysisServer(options);
+	}
+
+	//returns false if a regression was found
+	bool runMoveTimeBenchmark(const char** argv, int argc) {
+		if (argc >= 3 && std::strcmp(argv[2], "diff") == 0) {
+			if (argc != 5) {
+				std::println("Error: measure_move_time diff requires 2 arguments: [baseline.json, candidate.json]");
+				return true;
+			}
+			return compareMoveTimes(argv[3], argv[4]);
+		}
+		if (argc > 5) {
+			std::println("Error: measure_move_time takes at most 3 arguments: [max depth, runs, output.json]");
+			return true;
+		}
+
+		MoveTimeOptions options;
+		if (argc >= 3) {
+			auto maxDepth = parseUnsignedArgument(argv[2]);
+			if (!maxDepth || *maxDepth < 1 || *maxDepth > MAX_SEARCH_DEPTH.get()) {
+				std::println("Error: max depth must be between 1 and {}", static_cast<std::uint32_t>(MAX_SEARCH_DEPTH.get()));
+				return true;
+			}
+			options.maxDepth = static_cast<int>(*maxDepth);
+		}
+		if (argc >= 4) {
+			auto runs = parseUnsignedArgument(argv[3]);
+			if (!runs || *runs < 2) {
+				std::println("Error: at least 2 runs are needed to estimate the variance");
+				return true;
+			}
+			options.measuredRuns = static_cast<int>(*runs);
+		}
+		if (argc == 5) {
+			options.outputPath = argv[4];
+		}
+		measureMoveTime(options);
+		return true;
+	}
+
+	void runSearchAnalytics(const char** argv, int argc) {
+		if (argc > 4) {
+			std::println("Error: search_analytics takes at most 2 arguments: [depth, output.json]");
+			return;
+		}
+
+		SearchAnalyticsOptions options;
+		if (argc >= 3) {
+			auto depth = parseUnsignedArgument(argv[2]);
+			if (!depth || *depth < 1 || *depth > MAX_SEARCH_DEPTH.get()) {
+				std::println("Error: depth must be between 1 and {}", static_cast<std::uint32_t>(MAX_SEARCH_DEPTH.get()));
+				return;
+			}
+			options.depth = static_cast<int>(*depth);
+		}
+		if (argc == 4) {
+			options.outputPath = argv[3];
+		}
+		measureSearchAnalytics(options);
+	}
+
+	void runUCILatencyBenchmark(const char** argv, int argc) {
+		if (argc > 4) {
+			std::println("Error: uci_latency takes at most 2 arguments: [iterations, depth]");
+			return;
+		}
+
+		tests::UCILatencyOptions options;
+		if (argc >= 3) {
+			auto iterations = parseUnsignedArgument(argv[2]);
+			if (!iterations || *iterations == 0) {
+				std::println("Error: could not parse iterations argument");
+				return;
+			}
+			options.iterations = *iterations;
+		}
+		if (argc == 4) {
+			auto depth = parseUnsignedArgument(argv[3]);
+			if (!depth || *depth < 1 || *depth > MAX_SEARCH_DEPTH.get()) {
+				std::println("Error: depth must be between 1 and {}", static_cast<std::uint32_t>(MAX_SEARCH_DEPTH.get()));
+				return;
+			}
+			options.depth = static_cast<std::uint8_t>(*depth);
+		}
+		tests::measureUCILatency(options);
+	}
+
 	void printCommandLineArgumentOptions() {
 		std::println("Options:");
 		std::println("(none)\t\t\t\t\t\t- Start the engine in UCI mode (default depth = 6)");
@@ -81,13 +325,24 @@ namespace chess {
 		std::println("draw_bitboard [bitboard, base, filename]\t- Draw a bitboard image");
 		std::println("generate_bmi_table");
 		std::println("see_move_priorities [fen]");
-		std::println("measure_move_time");
+		std::println("measure_move_time [max depth, runs, output.json]\t- Benchmark time to depth");
+		std::println("search_analytics [depth, output.json]\t\t- Export per ply search tree statistics as JSON");
+		std::println("bench\t\t\t\t\t\t- Time the core primitives in ns/op and cycles/op");
+		std::println("uci_latency [iterations, depth]\t\t\t- Measure UCI response latencies of a child engine");
+		std::println("measure_move_time diff [baseline.json, candidate.json]\t- Flag significant time to depth regressions");
+		std::println("suite [file.epd, depth|movetime, value]\t\t- Solve an EPD test suite, printing JSON results");
+		std::println("selfplay [openings, games, config1.json, config2.json]\t- Play a match between two engine configurations");
+		std::println("spsa [openings, iterations, depth|movetime, value, output.json]\t- Tune search parameters with SPSA self-play");
+		std::println("pgn_stats [file.pgn]\t\t\t\t- Read every position of a PGN file");
+		std::println("datagen [output, games, nodes]\t\t\t- Generate training positions from fixed node self-play");
+		std::println("analyze_server [max threads per request]\t- Analyze JSON lines requests from stdin");
 	}
 }
 
 int main(int argc, const char** argv) {
 	chess::arena::init();
 
+	auto exitCode = 0;
 	if (argc == 1) {
 		constexpr chess::SafeUnsigned<std::uint8_t> DEFAULT_DEPTH{ 8 };
 		chess::playUCI(DEFAULT_DEPTH);
@@ -102,10 +357,35 @@ int main(int argc, const char** argv) {
 	} else if (std::strcmp(argv[1], "generate_bmi_table") == 0) {
 		chess::storeBMITable();
 	} else if (std::strcmp(argv[1], "measure_move_time") == 0) {
-		chess::measureMoveTime();
+		if (!chess::runMoveTimeBenchmark(argv, argc)) {
+			exitCode = 1;
+		}
+	} else if (std::strcmp(argv[1], "search_analytics") == 0) {
+		chess::runSearchAnalytics(argv, argc);
+	} else if (std::strcmp(argv[1], "bench") == 0) {
+		chess::runMicrobenchmarks();
+	} else if (std::strcmp(argv[1], "uci_latency") == 0) {
+		chess::runUCILatencyBenchmark(argv, argc);
+	} else if (std::strcmp(argv[1], "suite") == 0) {
+		chess::runSuite(argv, argc);
+	} else if (std::strcmp(argv[1], "selfplay") == 0) {
+		chess::runSelfPlayMatch(argv, argc);
+	} else if (std::strcmp(argv[1], "spsa") == 0) {
+		chess::runSPSATuning(argv, argc);
+	} else if (std::strcmp(argv[1], "pgn_stats") == 0) {
+		chess::printPGNStats(argv, argc);
+	} else if (std::strcmp(argv[1], "datagen") == 0) {
+		chess::runDataGeneration(argv, argc);
+	} else if (std::strcmp(argv[1], "analyze_server") == 0) {
+		chess::runAnalysisServerMode(argv, argc);
 	} else {
 		std::print("Invalid command line arguments. ");
 		chess::printCommandLineArgumentOptions();
 	}
-	return 0;
+
+	if constexpr (chess::profiler::ENABLED) {
+		auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+		chess::profiler::saveSession(std::format("session_{:%Y%m%d_%H%M%S}", now));
+	}
+	return exitCode;
 }
\ No newline at end of file